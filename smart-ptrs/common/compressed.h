@@ -0,0 +1,84 @@
+#pragma once
+
+#include <pool/region.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+// A 32-bit pointer space: one `Region` per `Tag`, reserved on first use, and addresses in it
+// stored as offsets from its base. With `Shift`, offsets count `2^Shift`-byte granules and
+// the space grows from 4 GB to 4 GB << Shift, every object in it aligned to a granule.
+// The region is shared by every user of `Tag` in the process, allocating is thread-safe.
+//
+//     struct GraphTag {};
+//     using GraphSpace = CompressedSpace<GraphTag, 3>;  // 32 GB
+template <typename Tag, size_t Shift = 0>
+class CompressedSpace {
+public:
+    static constexpr size_t kGranule = size_t(1) << Shift;
+    static constexpr size_t kCapacity = (size_t(1) << 32) << Shift;
+
+    // Never unmapped: objects in the space may outlive static destruction
+    static Region& GetRegion() {
+        static Region* region = new Region(kCapacity);
+        return *region;
+    }
+
+    static void* Allocate(size_t size, size_t alignment) {
+        return GetRegion().Allocate(size, alignment > kGranule ? alignment : kGranule);
+    }
+
+    // `ptr` is null or points into the region at a granule boundary
+    static uint32_t Compress(const void* ptr) {
+        if (!ptr) {
+            return 0;
+        }
+        assert(GetRegion().Contains(ptr));
+        assert((static_cast<const char*>(ptr) - Base()) % kGranule == 0);
+        return static_cast<uint32_t>((static_cast<const char*>(ptr) - Base()) >> Shift);
+    }
+    static void* Decompress(uint32_t offset) {
+        if (!offset) {
+            return nullptr;
+        }
+        return Base() + (static_cast<size_t>(offset) << Shift);
+    }
+
+private:
+    static char* Base() {
+        return GetRegion().Base();
+    }
+};
+
+// Non-owning pointer to a `T` in `Space`, four bytes wide.
+template <typename T, typename Space>
+class CompressedPtr {
+public:
+    CompressedPtr() = default;
+    CompressedPtr(std::nullptr_t) {
+    }
+    explicit CompressedPtr(T* ptr) : offset_(Space::Compress(ptr)) {
+    }
+
+    T* Get() const {
+        return static_cast<T*>(Space::Decompress(offset_));
+    }
+    T& operator*() const {
+        return *Get();
+    }
+    T* operator->() const {
+        return Get();
+    }
+    explicit operator bool() const {
+        return offset_;
+    }
+    uint32_t Offset() const {
+        return offset_;
+    }
+
+    bool operator==(const CompressedPtr&) const = default;
+
+private:
+    uint32_t offset_ = 0;
+};
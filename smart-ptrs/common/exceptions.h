@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdlib>
+
+// Lets the library build with -fno-exceptions. There every throw becomes `std::abort()`,
+// like allocation failures in `operator new`, and cleanup handlers are compiled but never run.
+// Code that must not abort uses the non-throwing alternatives (`TryLock`, `TrySharedFromThis`,
+// `TryMakeUniqueAligned`, the `std::error_code` overloads, ...).
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define SMART_PTRS_EXCEPTIONS 1
+#define SMART_PTRS_TRY try
+#define SMART_PTRS_CATCH_ALL catch (...)
+#define SMART_PTRS_RETHROW throw
+#define SMART_PTRS_THROW(...) throw __VA_ARGS__
+#else
+#define SMART_PTRS_EXCEPTIONS 0
+#define SMART_PTRS_TRY if (true)
+#define SMART_PTRS_CATCH_ALL else
+#define SMART_PTRS_RETHROW std::abort()
+#define SMART_PTRS_THROW(...) std::abort()
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A pointer to `T` and a `Bits`-wide tag in one word. The tag lives in the low bits,
+// which are always zero in the address of a `T`, so at most log2(alignof(T)) of them.
+// Non-owning building block of `TaggedUniquePtr` and `TaggedIntrusivePtr`.
+template <typename T, size_t Bits>
+class TaggedPointer {
+    static_assert(Bits > 0, "Use a plain pointer");
+
+public:
+    static constexpr uintptr_t kTagMask = (uintptr_t(1) << Bits) - 1;
+
+    TaggedPointer() = default;
+    explicit TaggedPointer(T* ptr, uintptr_t tag = 0)
+        : word_(reinterpret_cast<uintptr_t>(ptr) | (tag & kTagMask)) {
+        CheckAlignment();
+    }
+
+    T* Get() const {
+        CheckAlignment();
+        return reinterpret_cast<T*>(word_ & ~kTagMask);
+    }
+    uintptr_t GetTag() const {
+        return word_ & kTagMask;
+    }
+
+    // Keeps the tag
+    void SetPointer(T* ptr) {
+        CheckAlignment();
+        word_ = reinterpret_cast<uintptr_t>(ptr) | GetTag();
+    }
+    // Extra high bits of `tag` are dropped
+    void SetTag(uintptr_t tag) {
+        word_ = (word_ & ~kTagMask) | (tag & kTagMask);
+    }
+
+    bool operator==(const TaggedPointer&) const = default;
+
+private:
+    // Not at class scope: `T` may still be incomplete there, as in a node pointing to its
+    // own type
+    static constexpr void CheckAlignment() {
+        static_assert((size_t(1) << Bits) <= alignof(T),
+                      "Not enough alignment: at most log2(alignof(T)) tag bits fit, use alignas");
+    }
+
+    uintptr_t word_ = 0;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "exceptions.h"
+
+#include <cstddef>
+#include <new>
+#include <span>
+
+// Mixin for a fixed header followed by a variable number of `Elem`s in the same allocation.
+// `Derived` must be the most derived type: the tail starts right after `sizeof(Derived)`.
+// The tail is built after the header, so it is not usable from `Derived`'s constructor.
+template <typename Derived, typename Elem>
+class TrailingArray {
+public:
+    using TrailingElement = Elem;
+
+    // The tail is not part of the object, a copy would keep the size and lose the elements
+    TrailingArray() = default;
+    TrailingArray(const TrailingArray&) = delete;
+    TrailingArray& operator=(const TrailingArray&) = delete;
+
+    Elem* Tail() {
+        return reinterpret_cast<Elem*>(reinterpret_cast<char*>(static_cast<Derived*>(this)) +
+                                       TailOffset());
+    }
+    const Elem* Tail() const {
+        return reinterpret_cast<const Elem*>(
+            reinterpret_cast<const char*>(static_cast<const Derived*>(this)) + TailOffset());
+    }
+    size_t TailSize() const {
+        return tail_size_;
+    }
+    std::span<Elem> TailSpan() {
+        return {Tail(), tail_size_};
+    }
+    std::span<const Elem> TailSpan() const {
+        return {Tail(), tail_size_};
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // For factories
+
+    static constexpr size_t TailOffset() {
+        return (sizeof(Derived) + alignof(Elem) - 1) / alignof(Elem) * alignof(Elem);
+    }
+
+    // Bytes from the start of the header to the end of a tail of `count` elements.
+    static constexpr size_t AllocationSize(size_t count) {
+        return TailOffset() + count * sizeof(Elem);
+    }
+
+    // Value-initializes `count` elements behind a constructed header.
+    static void ConstructTail(Derived* object, size_t count) {
+        static_assert(alignof(Elem) <= alignof(Derived), "Tail would be misaligned");
+        Elem* tail = object->Tail();
+        size_t i = 0;
+        SMART_PTRS_TRY {
+            for (; i < count; ++i) {
+                ::new (tail + i) Elem();
+            }
+        } SMART_PTRS_CATCH_ALL {
+            while (i-- > 0) {
+                tail[i].~Elem();
+            }
+            SMART_PTRS_RETHROW;
+        }
+        object->tail_size_ = count;
+    }
+
+    static void DestroyTail(Derived* object) {
+        Elem* tail = object->Tail();
+        for (size_t i = object->tail_size_; i-- > 0;) {
+            tail[i].~Elem();
+        }
+        object->tail_size_ = 0;
+    }
+
+private:
+    size_t tail_size_ = 0;
+};
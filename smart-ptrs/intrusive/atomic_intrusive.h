@@ -0,0 +1,161 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// `IntrusivePtr` slot that threads read and replace concurrently, without locks.
+//
+// Deferred counting: when a pointer is stored, the slot takes `kBatch` references to it at once
+// and keeps a count of the ones handed out in the top 16 bits of the same word. `Load` bumps that
+// count with one compare-exchange and takes a reference that is already paid for, so the object
+// cannot be destroyed between reading the pointer and counting it. Whoever replaces the pointer
+// returns the references that were not handed out. Past `kRefill` handed out, every loader helps
+// topping the batch up; the last reference of a batch is never handed out, so `Exchange` always
+// has one to return. `Load` only waits if `kBatch - kRefill` loaders stall before topping up.
+//
+// `T` counts with `IncRef(n)` / `DecRef(n)` that are safe between threads: `AtomicRefCounted`.
+// Needs user-space pointers below 2^48 (x86-64, AArch64 without top byte tagging), debug
+// builds assert on it.
+//
+// While an object sits in a slot its count includes the unused part of the batch, so
+// `UseCount() == 1` and similar uniqueness checks never hold for it.
+template <typename T>
+class AtomicIntrusivePtr {
+    static_assert(sizeof(uintptr_t) == 8, "AtomicIntrusivePtr needs 64-bit pointers");
+
+public:
+    AtomicIntrusivePtr() = default;
+    AtomicIntrusivePtr(IntrusivePtr<T> ptr) : word_(Install(std::move(ptr))) {
+    }
+    AtomicIntrusivePtr(const AtomicIntrusivePtr&) = delete;
+    AtomicIntrusivePtr& operator=(const AtomicIntrusivePtr&) = delete;
+
+    ~AtomicIntrusivePtr() {
+        Retire(word_.load(std::memory_order_acquire));
+    }
+
+    IntrusivePtr<T> Load() const {
+        uintptr_t word = word_.load(std::memory_order_relaxed);
+        while (T* ptr = PtrOf(word)) {
+            if (CountOf(word) + 1 >= kBatch) {
+                // Batch exhausted, wait for the loaders topping it up
+                word = word_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (word_.compare_exchange_weak(word, word + kOne, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                if (CountOf(word) >= kRefill) {
+                    Refill(ptr);
+                }
+                return Adopt(ptr);
+            }
+        }
+        return nullptr;
+    }
+
+    void Store(IntrusivePtr<T> desired) {
+        Retire(word_.exchange(Install(std::move(desired)), std::memory_order_acq_rel));
+    }
+
+    IntrusivePtr<T> Exchange(IntrusivePtr<T> desired) {
+        return Take(word_.exchange(Install(std::move(desired)), std::memory_order_acq_rel));
+    }
+
+    // Stores `desired` if the slot holds `expected.Get()`, otherwise loads the current
+    // pointer into `expected`. Concurrent loads only make the exchange retry.
+    bool CompareExchange(IntrusivePtr<T>& expected, IntrusivePtr<T> desired) {
+        uintptr_t word = word_.load(std::memory_order_relaxed);
+        if (PtrOf(word) != expected.Get()) {
+            expected = Load();
+            return false;
+        }
+        uintptr_t desired_word = Install(std::move(desired));
+        while (!word_.compare_exchange_weak(word, desired_word, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+            if (PtrOf(word) != expected.Get()) {
+                Retire(desired_word);
+                expected = Load();
+                return false;
+            }
+        }
+        Retire(word);
+        return true;
+    }
+
+    static constexpr bool IsLockFree() {
+        return std::atomic<uintptr_t>::is_always_lock_free;
+    }
+
+private:
+    static constexpr int kCountShift = 48;
+    static constexpr uintptr_t kOne = uintptr_t(1) << kCountShift;
+    static constexpr uintptr_t kPtrMask = kOne - 1;
+    // The handed out count stays below `kBatch`, well within the 16 count bits
+    static constexpr size_t kBatch = size_t(1) << 15;
+    static constexpr size_t kRefill = kBatch / 2;
+
+    static T* PtrOf(uintptr_t word) {
+        return reinterpret_cast<T*>(word & kPtrMask);
+    }
+    static size_t CountOf(uintptr_t word) {
+        return word >> kCountShift;
+    }
+
+    static IntrusivePtr<T> Adopt(T* ptr) {
+        IntrusivePtr<T> result;
+        result.ptr_ = ptr;
+        return result;
+    }
+
+    // Turns the reference of `ptr` into a batch of `kBatch`
+    static uintptr_t Install(IntrusivePtr<T> ptr) {
+        static_assert(HasAtomicRefCount<T>::value,
+                      "AtomicIntrusivePtr needs a thread-safe count, derive from AtomicRefCounted");
+        T* raw = std::exchange(ptr.ptr_, nullptr);
+        assert((reinterpret_cast<uintptr_t>(raw) & ~kPtrMask) == 0 && "pointer above 2^48");
+        if (raw) {
+            raw->IncRef(kBatch - 1);
+        }
+        return reinterpret_cast<uintptr_t>(raw);
+    }
+
+    // Returns the references of a replaced word that were not handed out
+    static void Retire(uintptr_t word) {
+        if (T* ptr = PtrOf(word)) {
+            ptr->DecRef(kBatch - CountOf(word));
+        }
+    }
+
+    // Same as `Retire`, but keeps one reference for the caller: `Load` never hands out the last one
+    static IntrusivePtr<T> Take(uintptr_t word) {
+        T* ptr = PtrOf(word);
+        if (ptr && CountOf(word) + 1 < kBatch) {
+            ptr->DecRef(kBatch - CountOf(word) - 1);
+        }
+        return Adopt(ptr);
+    }
+
+    // Pays `kRefill` references in advance and takes them off the handed out count. If another
+    // loader got there first or `ptr` was replaced, they are returned; if `ptr` was stored again,
+    // the new batch gets them, either way the object's count matches its holders.
+    // The caller owns a reference, so `ptr` stays alive throughout.
+    void Refill(T* ptr) const {
+        ptr->IncRef(kRefill);
+        uintptr_t word = word_.load(std::memory_order_relaxed);
+        while (PtrOf(word) == ptr && CountOf(word) >= kRefill) {
+            // Release: a replacer that sees the lower count also sees the references paid for it
+            if (word_.compare_exchange_weak(word, word - kRefill * kOne, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        ptr->DecRef(kRefill);
+    }
+
+    mutable std::atomic<uintptr_t> word_ = 0;
+};
@@ -0,0 +1,68 @@
+// Copies and destroys pointers to a foreign type: `IntrusivePtr` with counts in `RefCountTable`
+// against `SharedPtr(T*)`, which allocates a control block per object.
+//
+//     ./bench_external_refs [objects] [rounds]
+
+#include "external_refs.h"
+
+#include <shared-from-this/shared.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct Blob {
+    int payload[4];
+};
+
+template <>
+struct IntrusiveRefs<Blob> : ExternalRefs<Blob> {};
+
+template <typename Ptr, typename Make>
+double Run(size_t objects, size_t rounds, Make make) {
+    auto start = std::chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (size_t round = 0; round < rounds; ++round) {
+        std::vector<Ptr> owners;
+        owners.reserve(objects);
+        for (size_t i = 0; i < objects; ++i) {
+            owners.push_back(make());
+        }
+        // Every object gets shared a few times, like handles passed around
+        std::vector<Ptr> copies;
+        copies.reserve(objects * 4);
+        for (int copy = 0; copy < 4; ++copy) {
+            for (const Ptr& owner : owners) {
+                copies.push_back(owner);
+            }
+        }
+        checksum += copies.back().UseCount();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (checksum != rounds * 5) {
+        std::abort();
+    }
+    // Nanoseconds per object: one creation, four copies, five releases
+    return elapsed.count() * 1e9 / (objects * rounds);
+}
+
+int main(int argc, char** argv) {
+    size_t objects = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+
+    double external = Run<IntrusivePtr<Blob>>(objects, rounds, [] {
+        return IntrusivePtr<Blob>(new Blob());
+    });
+    double shared = Run<SharedPtr<Blob>>(objects, rounds, [] {
+        return SharedPtr<Blob>(new Blob());
+    });
+    double make_shared = Run<SharedPtr<Blob>>(objects, rounds, [] {
+        return MakeShared<Blob>();
+    });
+
+    std::printf("ns per object (%zu objects x %zu rounds)\n", objects, rounds);
+    std::printf("  IntrusivePtr + RefCountTable  %8.1f\n", external);
+    std::printf("  SharedPtr(T*)                 %8.1f\n", shared);
+    std::printf("  MakeShared (for reference)    %8.1f\n", make_shared);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <common/compressed.h>
+
+#include <cstddef>  // for std::nullptr_t
+#include <new>
+#include <type_traits>
+#include <utility>  // for std::forward / std::swap
+
+// Deleter for `RefCounted` objects made by `MakeCompressedIntrusive`: the memory belongs to
+// the region of the space.
+struct DestroyInPlace {
+    template <typename T>
+    static void Destroy(T* object) {
+        object->~T();
+    }
+};
+
+// `IntrusivePtr` into a `CompressedSpace`, four bytes wide.
+template <typename T, typename Space>
+class CompressedIntrusivePtr {
+public:
+    // Constructors
+    CompressedIntrusivePtr() = default;
+    CompressedIntrusivePtr(std::nullptr_t) {
+    }
+    CompressedIntrusivePtr(T* ptr) : ptr_(ptr) {
+        Inc();
+    }
+    CompressedIntrusivePtr(const CompressedIntrusivePtr& other) : ptr_(other.ptr_) {
+        Inc();
+    }
+    CompressedIntrusivePtr(CompressedIntrusivePtr&& other) : ptr_(std::exchange(other.ptr_, nullptr)) {
+    }
+
+    // `operator=`-s
+    CompressedIntrusivePtr& operator=(CompressedIntrusivePtr other) {
+        Swap(other);
+        return *this;
+    }
+
+    // Destructor
+    ~CompressedIntrusivePtr() {
+        Dec();
+    }
+
+    // Modifiers
+    void Reset(T* ptr = nullptr) {
+        CompressedIntrusivePtr(ptr).Swap(*this);
+    }
+    void Swap(CompressedIntrusivePtr& other) {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    // Observers
+    T* Get() const {
+        return ptr_.Get();
+    }
+    T& operator*() const {
+        return *Get();
+    }
+    T* operator->() const {
+        return Get();
+    }
+    size_t UseCount() const {
+        return ptr_ ? IntrusiveRefs<T>::RefCount(Get()) : 0;
+    }
+    explicit operator bool() const {
+        return static_cast<bool>(ptr_);
+    }
+
+private:
+    void Inc() {
+        if (ptr_) {
+            IntrusiveRefs<T>::IncRef(Get());
+        }
+    }
+    void Dec() {
+        if (ptr_) {
+            IntrusiveRefs<T>::DecRef(Get());
+        }
+    }
+
+    CompressedPtr<T, Space> ptr_;
+};
+
+template <typename T, typename Space>
+bool operator==(const CompressedIntrusivePtr<T, Space>& left,
+                const CompressedIntrusivePtr<T, Space>& right) {
+    return left.Get() == right.Get();
+}
+
+// `MakeIntrusive` in the region of `Space`. `T` has to release itself with `DestroyInPlace`.
+template <typename T, typename Space, typename... Args>
+CompressedIntrusivePtr<T, Space> MakeCompressedIntrusive(Args&&... args) {
+    static_assert(std::is_same_v<typename T::DeleterType, DestroyInPlace>,
+                  "The memory belongs to the region, derive from RefCounted<T, ..., DestroyInPlace>");
+    void* place = Space::Allocate(sizeof(T), alignof(T));
+    return CompressedIntrusivePtr<T, Space>(::new (place) T(std::forward<Args>(args)...));
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Reference counts of objects that have no room for one, keyed by address.
+// Lock-striped: the address picks a shard with its own mutex, inside a shard the counts live
+// in an open-addressing table with linear probing. An entry exists while its count is non-zero.
+class RefCountTable {
+public:
+    static RefCountTable& Instance() {
+        static RefCountTable table;
+        return table;
+    }
+
+    // Returns the new count, 1 for an address seen the first time.
+    size_t Inc(const void* key) {
+        Shard& shard = ShardOf(key);
+        std::lock_guard lock(shard.mutex);
+        if ((shard.size + 1) * 4 > shard.slots.size() * 3) {
+            shard.Grow();
+        }
+        Slot& slot = shard.slots[shard.Find(key)];
+        if (!slot.key) {
+            slot.key = key;
+            ++shard.size;
+        }
+        return ++slot.count;
+    }
+
+    // Returns the new count, the entry is gone at 0. `key` must have been counted.
+    size_t Dec(const void* key) {
+        Shard& shard = ShardOf(key);
+        std::lock_guard lock(shard.mutex);
+        size_t index = shard.Find(key);
+        size_t count = --shard.slots[index].count;
+        if (!count) {
+            shard.Erase(index);
+        }
+        return count;
+    }
+
+    size_t Count(const void* key) const {
+        const Shard& shard = ShardOf(key);
+        std::lock_guard lock(shard.mutex);
+        if (shard.slots.empty()) {
+            return 0;
+        }
+        return shard.slots[shard.Find(key)].count;
+    }
+
+    // Number of counted addresses.
+    size_t Size() const {
+        size_t size = 0;
+        for (const Shard& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            size += shard.size;
+        }
+        return size;
+    }
+
+private:
+    static constexpr size_t kShards = 16;  // indexed by the top 4 bits of `Mix`
+    static constexpr size_t kMinCapacity = 16;
+
+    struct Slot {
+        const void* key = nullptr;
+        size_t count = 0;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::vector<Slot> slots;
+        size_t size = 0;
+
+        size_t Home(const void* key) const {
+            return Hash(key) & (slots.size() - 1);
+        }
+
+        // Slot holding `key` or the empty slot where it would go. Needs a non-empty table.
+        size_t Find(const void* key) const {
+            size_t mask = slots.size() - 1;
+            size_t index = Home(key);
+            while (slots[index].key && slots[index].key != key) {
+                index = (index + 1) & mask;
+            }
+            return index;
+        }
+
+        // Backward-shift deletion: no tombstones, probe chains stay short.
+        void Erase(size_t hole) {
+            size_t mask = slots.size() - 1;
+            for (size_t next = (hole + 1) & mask; slots[next].key; next = (next + 1) & mask) {
+                // Move `next` into the hole unless its home lies cyclically in (hole, next]
+                size_t home = Home(slots[next].key);
+                if (((next - home) & mask) >= ((next - hole) & mask)) {
+                    slots[hole] = slots[next];
+                    hole = next;
+                }
+            }
+            slots[hole] = Slot();
+            --size;
+        }
+
+        void Grow() {
+            std::vector<Slot> old = std::move(slots);
+            slots.assign(old.empty() ? kMinCapacity : old.size() * 2, Slot());
+            for (const Slot& slot : old) {
+                if (slot.key) {
+                    slots[Find(slot.key)] = slot;
+                }
+            }
+        }
+    };
+
+    // Fibonacci hashing, the low bits of an address are mostly alignment.
+    // The top bits pick the shard, the bits below the slot.
+    static uint64_t Mix(const void* key) {
+        return reinterpret_cast<uintptr_t>(key) * 0x9E3779B97F4A7C15ull;
+    }
+    static size_t Hash(const void* key) {
+        return static_cast<size_t>(Mix(key) >> 16);
+    }
+    Shard& ShardOf(const void* key) {
+        return shards_[Mix(key) >> 60];
+    }
+    const Shard& ShardOf(const void* key) const {
+        return shards_[Mix(key) >> 60];
+    }
+
+    std::array<Shard, kShards> shards_;
+};
+
+// `IntrusiveRefs` for a type that does not count itself: the count lives in `RefCountTable`,
+// `Deleter` releases the object when it drops to zero. No allocation per object beyond the
+// table slot, unlike the control block of `SharedPtr(T*)`.
+//
+//     template <>
+//     struct IntrusiveRefs<sqlite3> : ExternalRefs<sqlite3, CloseDatabase> {};
+template <typename T, typename Deleter = DefaultDelete>
+struct ExternalRefs {
+    static void IncRef(T* ptr) {
+        RefCountTable::Instance().Inc(ptr);
+    }
+    static void DecRef(T* ptr) {
+        if (!RefCountTable::Instance().Dec(ptr)) {
+            Deleter().Destroy(ptr);
+        }
+    }
+    static size_t RefCount(const T* ptr) {
+        return RefCountTable::Instance().Count(ptr);
+    }
+};
@@ -1,21 +1,36 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>  // for std::nullptr_t
+#include <functional>  // for std::hash
+#include <type_traits>
 #include <utility>  // for std::exchange / std::swap
 
+// Counts from here on mark an immortal object: `IncRef`/`DecRef` leave the count alone
+// and it never drops to zero.
+inline constexpr size_t kImmortalRefCount = size_t(1) << (sizeof(size_t) * 8 - 1);
+
+// Counters take `n` references at once for holders that keep a batch, see `AtomicIntrusivePtr`.
 class SimpleCounter {
 public:
-    size_t IncRef() {
-        count_++;
+    size_t IncRef(size_t n = 1) {
+        if (count_ < kImmortalRefCount) {
+            count_ += n;
+        }
         return count_;
     }
-    size_t DecRef() {
-        count_--;
+    size_t DecRef(size_t n = 1) {
+        if (count_ < kImmortalRefCount) {
+            count_ -= n;
+        }
         return count_;
     }
     size_t RefCount() const {
         return count_;
     }
+    void MakeImmortal() {
+        count_ = kImmortalRefCount;
+    }
     SimpleCounter& operator=(const SimpleCounter& other) {
         return *this;
     }
@@ -24,6 +39,42 @@ private:
     size_t count_ = 0;
 };
 
+// `SimpleCounter` for objects shared between threads. `MakeImmortal` has to happen before
+// the object is shared.
+class AtomicCounter {
+public:
+    AtomicCounter() = default;
+    AtomicCounter(const AtomicCounter&) {
+    }
+
+    size_t IncRef(size_t n = 1) {
+        if (count_.load(std::memory_order_relaxed) >= kImmortalRefCount) {
+            return kImmortalRefCount;
+        }
+        return count_.fetch_add(n, std::memory_order_relaxed) + n;
+    }
+    // Acquire-release: whoever drops the count to zero sees all writes made under the other
+    // references before destroying the object.
+    size_t DecRef(size_t n = 1) {
+        if (count_.load(std::memory_order_relaxed) >= kImmortalRefCount) {
+            return kImmortalRefCount;
+        }
+        return count_.fetch_sub(n, std::memory_order_acq_rel) - n;
+    }
+    size_t RefCount() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+    void MakeImmortal() {
+        count_.store(kImmortalRefCount, std::memory_order_relaxed);
+    }
+    AtomicCounter& operator=(const AtomicCounter&) {
+        return *this;
+    }
+
+private:
+    std::atomic<size_t> count_ = 0;
+};
+
 struct DefaultDelete {
     template <typename T>
     static void Destroy(T* object) {
@@ -34,15 +85,17 @@ struct DefaultDelete {
 template <typename Derived, typename Counter, typename Deleter>
 class RefCounted {
 public:
-    void IncRef() {
-        counter_.IncRef();
+    using CounterType = Counter;
+    using DeleterType = Deleter;
+
+    void IncRef(size_t n = 1) {
+        counter_.IncRef(n);
     }
 
     // Decrease reference counter.
     // Destroy object using Deleter when the last instance dies.
-    void DecRef() {
-        counter_.DecRef();
-        if (counter_.RefCount() == 0) {
+    void DecRef(size_t n = 1) {
+        if (counter_.DecRef(n) == 0) {
             Deleter().Destroy(static_cast<Derived*>(this));
         }
     }
@@ -52,6 +105,15 @@ public:
         return counter_.RefCount();
     }
 
+    // Stops reference counting: the object is never destroyed, copies of pointers to it
+    // do not write to it. For process-lifetime singletons and sentinels.
+    void MakeImmortal() {
+        counter_.MakeImmortal();
+    }
+    bool IsImmortal() const {
+        return counter_.RefCount() >= kImmortalRefCount;
+    }
+
 private:
     Counter counter_;
 };
@@ -59,11 +121,43 @@ private:
 template <typename Derived, typename D = DefaultDelete>
 using SimpleRefCounted = RefCounted<Derived, SimpleCounter, D>;
 
+template <typename Derived, typename D = DefaultDelete>
+using AtomicRefCounted = RefCounted<Derived, AtomicCounter, D>;
+
+// Whether references to `T` may be taken and dropped from several threads at once.
+// Specialize for types that count atomically without `AtomicCounter`.
+template <typename T>
+struct HasAtomicRefCount : std::false_type {};
+
+template <typename T>
+    requires std::is_same_v<typename T::CounterType, AtomicCounter>
+struct HasAtomicRefCount<T> : std::true_type {};
+
+// How `IntrusivePtr` reaches the reference count of `T`: its member functions by default.
+// Specialize for types that cannot carry a count, see `ExternalRefs` in external_refs.h.
+template <typename T>
+struct IntrusiveRefs {
+    static void IncRef(T* ptr) {
+        ptr->IncRef();
+    }
+    static void DecRef(T* ptr) {
+        ptr->DecRef();
+    }
+    static size_t RefCount(const T* ptr) {
+        return ptr->RefCount();
+    }
+};
+
+template <typename T>
+class AtomicIntrusivePtr;
+
 template <typename T>
 class IntrusivePtr {
     template <typename Y>
     friend class IntrusivePtr;
 
+    friend class AtomicIntrusivePtr<T>;
+
 public:
     // Constructors
     IntrusivePtr() = default;
@@ -73,7 +167,7 @@ public:
     IntrusivePtr(T* ptr) {
         ptr_ = ptr;
         if (ptr_) {
-            ptr_->IncRef();
+            IntrusiveRefs<T>::IncRef(ptr_);
         }
     }
 
@@ -81,7 +175,7 @@ public:
     IntrusivePtr(const IntrusivePtr<Y>& other) {
         ptr_ = other.ptr_;
         if (other.ptr_) {
-            ptr_->IncRef();
+            IntrusiveRefs<T>::IncRef(ptr_);
         }
     }
 
@@ -95,7 +189,7 @@ public:
     IntrusivePtr(const IntrusivePtr& other) {
         ptr_ = other.ptr_;
         if (other.ptr_) {
-            ptr_->IncRef();
+            IntrusiveRefs<T>::IncRef(ptr_);
         }
     }
 
@@ -108,7 +202,7 @@ public:
     // `operator=`-s
     IntrusivePtr& operator=(const IntrusivePtr& other) {
         if (other.ptr_) {
-            other.ptr_->IncRef();
+            IntrusiveRefs<T>::IncRef(other.ptr_);
         }
         Dec();
         ptr_ = other.ptr_;
@@ -117,7 +211,7 @@ public:
     template <typename Y>
     IntrusivePtr& operator=(const IntrusivePtr<Y>& other) {
         if (other.ptr_) {
-            other.ptr_->IncRef();
+            IntrusiveRefs<T>::IncRef(other.ptr_);
         }
         Dec();
         ptr_ = other.ptr_;
@@ -157,7 +251,7 @@ public:
     void Reset(T* ptr) {
         Dec();
         if (ptr) {
-            ptr->IncRef();
+            IntrusiveRefs<T>::IncRef(ptr);
         }
         if (ptr_ != ptr) {
             ptr_ = ptr;
@@ -179,7 +273,7 @@ public:
     }
     size_t UseCount() const {
         if (ptr_) {
-            return ptr_->RefCount();
+            return IntrusiveRefs<T>::RefCount(ptr_);
         }
         return 0;
     }
@@ -193,12 +287,29 @@ public:
 private:
     void Dec() {
         if (ptr_) {
-            ptr_->DecRef();
+            IntrusiveRefs<T>::DecRef(ptr_);
         }
     }
     T* ptr_ = nullptr;
 };
 
+template <typename T, typename Y>
+inline bool operator==(const IntrusivePtr<T>& left, const IntrusivePtr<Y>& right) {
+    return left.Get() == right.Get();
+}
+
+template <typename T>
+bool operator==(const IntrusivePtr<T>& left, std::nullptr_t) noexcept {
+    return !left;
+}
+
+template <typename T>
+struct std::hash<IntrusivePtr<T>> {
+    size_t operator()(const IntrusivePtr<T>& ptr) const {
+        return std::hash<T*>()(ptr.Get());
+    }
+};
+
 template <typename T, typename... Args>
 IntrusivePtr<T> MakeIntrusive(Args&&... args) {
     IntrusivePtr<T> new_iptr = IntrusivePtr(new T(std::forward<Args>(args)...));
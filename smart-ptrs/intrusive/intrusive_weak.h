@@ -0,0 +1,149 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <cstddef>  // for std::nullptr_t
+#include <type_traits>
+#include <utility>  // for std::exchange / std::swap
+
+// Side block of a `WeakRefCounted` object, allocated by its first weak reference.
+// Shared by the object and its weak pointers, it outlives the object while any of them remain.
+class WeakRefBlock {
+public:
+    void IncRef() {
+        ++count_;
+    }
+    void DecRef() {
+        if (--count_ == 0) {
+            delete this;
+        }
+    }
+    bool Expired() const {
+        return expired_;
+    }
+    void Expire() {
+        expired_ = true;
+    }
+
+private:
+    size_t count_ = 1;  // the object's own reference
+    bool expired_ = false;
+};
+
+// `RefCounted` that can be observed by `IntrusiveWeakPtr`. The weak block is allocated on demand,
+// objects never referenced weakly pay one null pointer and nothing at runtime.
+// Single-threaded only: `Lock` and the lazy block allocation are not synchronized.
+template <typename Derived, typename Counter, typename Deleter>
+class WeakRefCounted : public RefCounted<Derived, Counter, Deleter> {
+    static_assert(std::is_same_v<Counter, SimpleCounter>,
+                  "Intrusive weak references are not thread-safe, use SimpleCounter");
+
+public:
+    WeakRefCounted() = default;
+    // A copy is a different object: no references, weak pointers keep observing the original
+    WeakRefCounted(const WeakRefCounted&) {
+    }
+    WeakRefCounted& operator=(const WeakRefCounted&) {
+        return *this;
+    }
+    ~WeakRefCounted() {
+        if (weak_) {
+            weak_->Expire();
+            weak_->DecRef();
+        }
+    }
+
+    WeakRefBlock* WeakBlock() const {
+        if (!weak_) {
+            weak_ = new WeakRefBlock();
+        }
+        return weak_;
+    }
+
+private:
+    mutable WeakRefBlock* weak_ = nullptr;
+};
+
+template <typename Derived, typename D = DefaultDelete>
+using SimpleWeakRefCounted = WeakRefCounted<Derived, SimpleCounter, D>;
+
+template <typename T>
+class IntrusiveWeakPtr {
+    template <typename Y>
+    friend class IntrusiveWeakPtr;
+
+public:
+    // Constructors
+    IntrusiveWeakPtr() = default;
+    IntrusiveWeakPtr(std::nullptr_t) {
+    }
+    template <typename Y>
+    IntrusiveWeakPtr(const IntrusivePtr<Y>& other) : ptr_(other.Get()) {
+        if (ptr_) {
+            block_ = ptr_->WeakBlock();
+            block_->IncRef();
+        }
+    }
+    IntrusiveWeakPtr(const IntrusiveWeakPtr& other) : ptr_(other.ptr_), block_(other.block_) {
+        Inc();
+    }
+    template <typename Y>
+    IntrusiveWeakPtr(const IntrusiveWeakPtr<Y>& other) : ptr_(other.ptr_), block_(other.block_) {
+        Inc();
+    }
+    IntrusiveWeakPtr(IntrusiveWeakPtr&& other)
+        : ptr_(std::exchange(other.ptr_, nullptr)), block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    // `operator=`-s
+    IntrusiveWeakPtr& operator=(IntrusiveWeakPtr other) {
+        Swap(other);
+        return *this;
+    }
+
+    // Destructor
+    ~IntrusiveWeakPtr() {
+        Reset();
+    }
+
+    // Modifiers
+    void Reset() {
+        if (block_) {
+            std::exchange(block_, nullptr)->DecRef();
+        }
+        ptr_ = nullptr;
+    }
+    void Swap(IntrusiveWeakPtr& other) {
+        std::swap(ptr_, other.ptr_);
+        std::swap(block_, other.block_);
+    }
+
+    // Observers
+    size_t UseCount() const {
+        if (Expired()) {
+            return 0;
+        }
+        return ptr_->RefCount();
+    }
+    bool Expired() const {
+        // Once the strong count is zero the destructor is about to run or running
+        return !block_ || block_->Expired() || !ptr_->RefCount();
+    }
+    // Empty pointer if expired.
+    IntrusivePtr<T> Lock() const {
+        if (Expired()) {
+            return nullptr;
+        }
+        return IntrusivePtr<T>(ptr_);
+    }
+
+private:
+    void Inc() {
+        if (block_) {
+            block_->IncRef();
+        }
+    }
+
+    T* ptr_ = nullptr;
+    WeakRefBlock* block_ = nullptr;
+};
@@ -0,0 +1,49 @@
+// Compiled with -fno-exceptions: instantiates the throwing paths of every header in this directory.
+
+#include "atomic_intrusive.h"
+#include "compressed_intrusive.h"
+#include "external_refs.h"
+#include "intrusive.h"
+#include "intrusive_weak.h"
+#include "object_pool.h"
+#include "tagged_intrusive.h"
+#include "trailing_intrusive.h"
+
+#include <string>
+
+struct IntrusivePath : SimpleRefCounted<IntrusivePath, TrailingDelete>,
+                       TrailingArray<IntrusivePath, std::string> {};
+
+struct IntrusiveShared : AtomicRefCounted<IntrusiveShared> {};
+
+struct IntrusiveWatched : SimpleWeakRefCounted<IntrusiveWatched> {};
+
+struct IntrusiveInPlace : SimpleRefCounted<IntrusiveInPlace, DestroyInPlace> {};
+
+struct IntrusiveSpaceTag {};
+
+struct IntrusiveHandle {
+    int fd;
+};
+
+template <>
+struct IntrusiveRefs<IntrusiveHandle> : ExternalRefs<IntrusiveHandle> {};
+
+void CheckIntrusiveNoExceptions() {
+    auto path = MakeIntrusiveWithTrailing<IntrusivePath>(2);
+    IntrusivePtr<IntrusivePath> copy = path;
+
+    AtomicIntrusivePtr<IntrusiveShared> slot(MakeIntrusive<IntrusiveShared>());
+    IntrusivePtr<IntrusiveShared> loaded = slot.Load();
+
+    auto watched = MakeIntrusive<IntrusiveWatched>();
+    IntrusiveWeakPtr<IntrusiveWatched> weak = watched;
+    IntrusivePtr<IntrusiveWatched> locked = weak.Lock();
+
+    TaggedIntrusivePtr<IntrusiveShared, 1> tagged(loaded, 1);
+
+    auto in_place =
+        MakeCompressedIntrusive<IntrusiveInPlace, CompressedSpace<IntrusiveSpaceTag>>();
+
+    IntrusivePtr<IntrusiveHandle> handle(new IntrusiveHandle{0});
+}
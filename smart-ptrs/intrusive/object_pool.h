@@ -0,0 +1,111 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <pool/stats.h>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class ObjectInPool;
+
+// Pool of reference counted objects: the last `DecRef` sends an object back instead of deleting it.
+// Reused objects are handed out as is, `Allocate` arguments only matter for fresh ones.
+template <typename T>
+class ObjectPool {
+    static_assert(std::is_base_of_v<ObjectInPool<T>, T>, "Unsupported type");
+
+public:
+    explicit ObjectPool(std::string name = "") : counters_(std::move(name)) {
+    }
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    IntrusivePtr<T> Allocate(Args&&... args) {
+        if (!objects_.empty()) {
+            std::unique_ptr<T> ptr = std::move(objects_.back());
+            objects_.pop_back();
+            counters_.OnReuse();
+            return IntrusivePtr<T>(ptr.release());
+        }
+        // Counted once constructed, a throwing constructor allocates nothing
+        IntrusivePtr<T> object = DoAllocate(std::forward<Args>(args)...);
+        counters_.OnMiss(sizeof(T));
+        return object;
+    }
+
+    // Preallocate `count` default constructed objects into the free list.
+    void Reserve(size_t count) {
+        while (count--) {
+            std::unique_ptr<T> object = std::make_unique<T>();
+            object->SetHome(this);
+            objects_.push_back(std::move(object));
+            counters_.OnReserve(sizeof(T));
+        }
+    }
+
+    void Release(T* ptr) {
+        objects_.emplace_back(ptr);
+        counters_.OnRelease();
+    }
+
+    size_t NumAvailable() const {
+        return counters_.NumAvailable();
+    }
+
+    size_t NumInUse() const {
+        return counters_.NumInUse();
+    }
+
+    PoolStats Stats() const {
+        return counters_.Snapshot();
+    }
+
+private:
+    template <typename... Args>
+    IntrusivePtr<T> DoAllocate(Args&&... args) {
+        std::unique_ptr<T> object = std::make_unique<T>(std::forward<Args>(args)...);
+        object->SetHome(this);
+        return IntrusivePtr<T>(object.release());
+    }
+
+private:
+    std::vector<std::unique_ptr<T>> objects_;
+    PoolCounters counters_;
+};
+
+template <typename Derived>
+class ObjectInPool {
+public:
+    void IncRef() {
+        count_++;
+    }
+
+    void DecRef() {
+        if (--count_ == 0) {
+            TakeMeHome();
+        }
+    }
+
+    size_t RefCount() const {
+        return count_;
+    }
+
+    void SetHome(ObjectPool<Derived>* pool) {
+        home_ = pool;
+    }
+
+private:
+    void TakeMeHome() {
+        home_->Release(static_cast<Derived*>(this));
+    }
+
+private:
+    size_t count_ = 0;
+    ObjectPool<Derived>* home_;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <common/tagged.h>
+
+#include <cstddef>  // for std::nullptr_t
+#include <cstdint>
+#include <utility>  // for std::swap
+
+// `IntrusivePtr` with `Bits` flags in the low bits of the pointer, still one word.
+// Copies carry the tag along, `Reset` keeps it.
+template <typename T, size_t Bits>
+class TaggedIntrusivePtr {
+public:
+    // Constructors
+    TaggedIntrusivePtr() = default;
+    TaggedIntrusivePtr(std::nullptr_t) {
+    }
+    explicit TaggedIntrusivePtr(T* ptr, uintptr_t tag = 0) : word_(ptr, tag) {
+        Inc();
+    }
+    TaggedIntrusivePtr(const IntrusivePtr<T>& ptr, uintptr_t tag = 0) : word_(ptr.Get(), tag) {
+        Inc();
+    }
+    TaggedIntrusivePtr(const TaggedIntrusivePtr& other) : word_(other.word_) {
+        Inc();
+    }
+    TaggedIntrusivePtr(TaggedIntrusivePtr&& other) : word_(other.word_) {
+        other.word_.SetPointer(nullptr);
+    }
+
+    // `operator=`-s
+    TaggedIntrusivePtr& operator=(TaggedIntrusivePtr other) {
+        Swap(other);
+        return *this;
+    }
+
+    // Destructor
+    ~TaggedIntrusivePtr() {
+        Dec();
+    }
+
+    // Modifiers
+    void Reset(T* ptr = nullptr) {
+        if (ptr) {
+            IntrusiveRefs<T>::IncRef(ptr);
+        }
+        Dec();
+        word_.SetPointer(ptr);
+    }
+    void SetTag(uintptr_t tag) {
+        word_.SetTag(tag);
+    }
+    void Swap(TaggedIntrusivePtr& other) {
+        std::swap(word_, other.word_);
+    }
+
+    // Observers
+    T* Get() const {
+        return word_.Get();
+    }
+    uintptr_t GetTag() const {
+        return word_.GetTag();
+    }
+    T& operator*() const {
+        return *Get();
+    }
+    T* operator->() const {
+        return Get();
+    }
+    size_t UseCount() const {
+        return Get() ? IntrusiveRefs<T>::RefCount(Get()) : 0;
+    }
+    explicit operator bool() const {
+        return Get();
+    }
+
+    // Shares the object with an untagged pointer
+    IntrusivePtr<T> ToIntrusive() const {
+        return IntrusivePtr<T>(Get());
+    }
+
+private:
+    void Inc() {
+        if (T* ptr = Get()) {
+            IntrusiveRefs<T>::IncRef(ptr);
+        }
+    }
+    void Dec() {
+        if (T* ptr = Get()) {
+            IntrusiveRefs<T>::DecRef(ptr);
+        }
+    }
+
+    TaggedPointer<T, Bits> word_;
+};
+
+// Compares the pointers, tags are not part of the identity
+template <typename T, size_t Bits>
+bool operator==(const TaggedIntrusivePtr<T, Bits>& left, const TaggedIntrusivePtr<T, Bits>& right) {
+    return left.Get() == right.Get();
+}
@@ -1,10 +1,12 @@
 #include "intrusive.h"
+#include "object_pool.h"
 
 #include <catch.hpp>
 
 #include "allocations_checker.h"
 
 #include <string>
+#include <unordered_set>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -241,6 +243,15 @@ TEST_CASE("Observers") {
     }
 }
 
+TEST_CASE("Hash") {
+    IntrusivePtr<MyString> a{new MyString{"hash"}};
+    IntrusivePtr<MyString> b = a;
+    IntrusivePtr<MyString> c{new MyString{"hash"}};
+    std::unordered_set<IntrusivePtr<MyString>> set{a, b, c};
+    REQUIRE(set.size() == 2);
+    REQUIRE(std::hash<IntrusivePtr<MyString>>()(a) == std::hash<MyString*>()(a.Get()));
+}
+
 TEST_CASE("From raw pointer") {
     MyString* str = new MyString{"Molodoy Krakodil khochet zavesti sebe druzey"};
     IntrusivePtr<MyString> a{str};
@@ -274,81 +285,6 @@ TEST_CASE("No copies") {
     IntrusivePtr<Pinned> p(new Pinned(1));
 }
 
-template <typename T>
-class ObjectInPool;
-
-template <typename T>
-class ObjectPool {
-    static_assert(std::is_base_of_v<ObjectInPool<T>, T>, "Unsupported type");
-
-public:
-    template <typename... Args>
-    IntrusivePtr<T> Allocate(Args&&... args) {
-        if (!objects_.empty()) {
-            std::unique_ptr<T> ptr = std::move(objects_.back());
-            objects_.pop_back();
-            return IntrusivePtr<T>(ptr.release());
-        }
-        return DoAllocate(std::forward<Args>(args)...);
-    }
-
-    void Release(T* ptr) {
-        objects_.emplace_back(ptr);
-    }
-
-    size_t NumAvailable() const {
-        return objects_.size();
-    }
-
-    size_t NumInUse() const {
-        return allocated_ - NumAvailable();
-    }
-
-private:
-    template <typename... Args>
-    IntrusivePtr<T> DoAllocate(Args&&... args) {
-        ++allocated_;
-        std::unique_ptr<T> object = std::make_unique<T>(std::forward<Args>(args)...);
-        object->SetHome(this);
-        return IntrusivePtr<T>(object.release());
-    }
-
-private:
-    std::vector<std::unique_ptr<T>> objects_;
-    size_t allocated_ = 0;
-};
-
-template <typename Derived>
-class ObjectInPool {
-public:
-    void IncRef() {
-        count_++;
-    }
-
-    void DecRef() {
-        if (--count_ == 0) {
-            TakeMeHome();
-        }
-    }
-
-    size_t RefCount() const {
-        return count_;
-    }
-
-    void SetHome(ObjectPool<Derived>* pool) {
-        home_ = pool;
-    }
-
-private:
-    void TakeMeHome() {
-        home_->Release(static_cast<Derived*>(this));
-    }
-
-private:
-    size_t count_ = 0;
-    ObjectPool<Derived>* home_;
-};
-
 struct PoolableString : ObjectInPool<PoolableString>, std::string {
     using std::string::basic_string;
 };
@@ -396,4 +332,61 @@ TEST_CASE("Object pool") {
         REQUIRE(strs.NumAvailable() == 3);
         REQUIRE(strs.NumInUse() == 1);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Object pool stats") {
+    ObjectPool<PoolableString> strs("strings");
+    strs.Reserve(2);
+
+    {
+        auto a = strs.Allocate("a");
+        auto b = strs.Allocate("b");
+        auto c = strs.Allocate("c");
+        auto stats = strs.Stats();
+        REQUIRE(stats.name == "strings");
+        REQUIRE(stats.allocations == 3);
+        REQUIRE(stats.reuses == 2);
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.in_use == 3);
+        REQUIRE(stats.available == 0);
+    }
+
+    auto a = strs.Allocate("a");
+    auto stats = strs.Stats();
+    REQUIRE(stats.allocations == 3);
+    REQUIRE(stats.reuses == 3);
+    REQUIRE(stats.in_use == 1);
+    REQUIRE(stats.peak_in_use == 3);
+    REQUIRE(stats.available == 2);
+    REQUIRE(stats.bytes_held == 3 * sizeof(PoolableString));
+
+    ObjectPool<PoolableString> empty;
+    REQUIRE_THROWS(empty.Allocate(std::string::npos, 'x'));
+    REQUIRE(empty.Stats().misses == 0);
+    REQUIRE(empty.Stats().in_use == 0);
+}
+
+TEST_CASE("Immortal") {
+    // Leaked through a static, like a process-lifetime singleton
+    static MyString* empty = new MyString();
+    empty->MakeImmortal();
+    REQUIRE(empty->IsImmortal());
+
+    {
+        IntrusivePtr<MyString> a(empty);
+        IntrusivePtr<MyString> b = a;
+        REQUIRE(a.UseCount() == kImmortalRefCount);
+        b.Reset();
+        a.Reset();
+    }
+    // Still alive, no one tried to delete it
+    REQUIRE(empty->RefCount() == kImmortalRefCount);
+
+    IntrusivePtr<MyInt> heap = MakeIntrusive<MyInt>(5);
+    heap->MakeImmortal();
+    // Intentionally never freed, keep it reachable for leak checkers
+    static MyInt* pinned = heap.Get();
+    REQUIRE(pinned->value == 5);
+    EXPECT_ZERO_ALLOCATIONS(heap.Reset());
+    REQUIRE(!heap);
+}
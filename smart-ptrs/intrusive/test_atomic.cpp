@@ -0,0 +1,113 @@
+#include "atomic_intrusive.h"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct Node : AtomicRefCounted<Node> {
+    explicit Node(int value) : value(value) {
+        alive.fetch_add(1);
+    }
+    ~Node() {
+        alive.fetch_sub(1);
+    }
+
+    int value;
+    inline static std::atomic<int> alive = 0;
+};
+
+struct SingleThreaded : SimpleRefCounted<SingleThreaded> {};
+
+TEST_CASE("Atomic intrusive slot") {
+    static_assert(AtomicIntrusivePtr<Node>::IsLockFree());
+    static_assert(HasAtomicRefCount<Node>::value);
+    static_assert(!HasAtomicRefCount<SingleThreaded>::value);
+
+    SECTION("Load and store") {
+        AtomicIntrusivePtr<Node> slot;
+        REQUIRE(!slot.Load());
+
+        auto node = MakeIntrusive<Node>(1);
+        slot.Store(node);
+        auto loaded = slot.Load();
+        REQUIRE(loaded == node);
+        REQUIRE(loaded->value == 1);
+
+        slot.Store(nullptr);
+        REQUIRE(!slot.Load());
+        REQUIRE(node.UseCount() == 2);
+    }
+
+    SECTION("Exchange hands over the reference") {
+        AtomicIntrusivePtr<Node> slot(MakeIntrusive<Node>(1));
+        auto first = slot.Exchange(MakeIntrusive<Node>(2));
+        REQUIRE(first->value == 1);
+        REQUIRE(first.UseCount() == 1);
+        REQUIRE(slot.Load()->value == 2);
+        first.Reset();
+        REQUIRE(Node::alive == 1);
+    }
+
+    SECTION("Compare exchange") {
+        auto a = MakeIntrusive<Node>(1);
+        auto b = MakeIntrusive<Node>(2);
+        AtomicIntrusivePtr<Node> slot(a);
+
+        IntrusivePtr<Node> expected = b;
+        REQUIRE(!slot.CompareExchange(expected, b));
+        REQUIRE(expected == a);
+        REQUIRE(slot.CompareExchange(expected, b));
+        REQUIRE(slot.Load() == b);
+        REQUIRE(a.UseCount() == 2);
+    }
+
+    SECTION("Many loads of one pointer") {
+        auto node = MakeIntrusive<Node>(1);
+        AtomicIntrusivePtr<Node> slot(node);
+        for (int i = 0; i < 100000; ++i) {
+            REQUIRE(slot.Load() == node);
+        }
+        slot.Store(nullptr);
+        REQUIRE(node.UseCount() == 1);
+    }
+
+    SECTION("Concurrent readers and writers") {
+        AtomicIntrusivePtr<Node> slot(MakeIntrusive<Node>(0));
+        std::atomic<bool> stop = false;
+        std::atomic<long> sum = 0;
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                // ASan reports a node read after its last reference was dropped
+                while (!stop.load()) {
+                    sum.fetch_add(slot.Load()->value, std::memory_order_relaxed);
+                }
+            });
+        }
+        for (int i = 0; i < 2; ++i) {
+            threads.emplace_back([&, i] {
+                for (int j = 1; j <= 20000; ++j) {
+                    if (j % 2) {
+                        slot.Store(MakeIntrusive<Node>(j));
+                    } else {
+                        auto expected = slot.Load();
+                        slot.CompareExchange(expected, MakeIntrusive<Node>(i));
+                    }
+                }
+            });
+        }
+        for (size_t i = 4; i < threads.size(); ++i) {
+            threads[i].join();
+        }
+        stop = true;
+        for (size_t i = 0; i < 4; ++i) {
+            threads[i].join();
+        }
+        REQUIRE(Node::alive == 1);
+        REQUIRE(slot.Exchange(nullptr).UseCount() == 1);
+    }
+
+    REQUIRE(Node::alive == 0);
+}
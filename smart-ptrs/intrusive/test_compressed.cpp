@@ -0,0 +1,48 @@
+#include "compressed_intrusive.h"
+
+#include <catch.hpp>
+
+struct GraphTag {};
+using GraphSpace = CompressedSpace<GraphTag>;
+
+struct Vertex : SimpleRefCounted<Vertex, DestroyInPlace> {
+    explicit Vertex(int id) : id(id) {
+        ++alive;
+    }
+    ~Vertex() {
+        --alive;
+    }
+
+    int id;
+    CompressedIntrusivePtr<Vertex, GraphSpace> edges[4];
+    inline static int alive = 0;
+};
+
+TEST_CASE("Compressed IntrusivePtr") {
+    static_assert(sizeof(CompressedIntrusivePtr<Vertex, GraphSpace>) == 4);
+    static_assert(sizeof(Vertex) <= 32);
+    // Does not compile, the last reference would `delete` memory of the region:
+    //     struct Plain : SimpleRefCounted<Plain> {};
+    //     MakeCompressedIntrusive<Plain, GraphSpace>();
+
+    SECTION("Shared vertices") {
+        {
+            auto a = MakeCompressedIntrusive<Vertex, GraphSpace>(1);
+            auto b = MakeCompressedIntrusive<Vertex, GraphSpace>(2);
+            a->edges[0] = b;
+            a->edges[1] = b;
+            REQUIRE(b.UseCount() == 3);
+            REQUIRE(a->edges[0] == b);
+            REQUIRE(a->edges[1]->id == 2);
+
+            b.Reset();
+            REQUIRE(Vertex::alive == 2);
+            a->edges[0].Reset();
+            a->edges[1] = nullptr;
+            REQUIRE(Vertex::alive == 1);
+
+            a->edges[2] = MakeCompressedIntrusive<Vertex, GraphSpace>(3);
+        }
+        REQUIRE(Vertex::alive == 0);
+    }
+}
@@ -0,0 +1,79 @@
+#include "external_refs.h"
+
+#include <catch.hpp>
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Stands in for a handle of a C library
+extern "C" {
+struct Handle {
+    int fd;
+};
+}
+
+static int open_handles = 0;
+
+Handle* OpenHandle(int fd) {
+    ++open_handles;
+    return new Handle{fd};
+}
+
+struct CloseHandle {
+    static void Destroy(Handle* handle) {
+        --open_handles;
+        delete handle;
+    }
+};
+
+template <>
+struct IntrusiveRefs<Handle> : ExternalRefs<Handle, CloseHandle> {};
+
+TEST_CASE("External reference counts") {
+    SECTION("IntrusivePtr over a foreign type") {
+        size_t counted = RefCountTable::Instance().Size();
+        {
+            IntrusivePtr<Handle> a(OpenHandle(3));
+            IntrusivePtr<Handle> b = a;
+            REQUIRE(a.UseCount() == 2);
+            REQUIRE(b->fd == 3);
+            REQUIRE(RefCountTable::Instance().Size() == counted + 1);
+
+            IntrusivePtr<Handle> c(OpenHandle(4));
+            b = c;
+            REQUIRE(a.UseCount() == 1);
+            REQUIRE(c.UseCount() == 2);
+            a.Reset();
+            REQUIRE(open_handles == 1);
+        }
+        REQUIRE(open_handles == 0);
+        REQUIRE(RefCountTable::Instance().Size() == counted);
+    }
+
+    SECTION("Table against a reference map") {
+        RefCountTable& table = RefCountTable::Instance();
+        std::vector<int> objects(5000);
+        std::unordered_map<const void*, size_t> expected;
+        std::mt19937 gen(7);
+        for (int step = 0; step < 100000; ++step) {
+            const void* key = &objects[gen() % objects.size()];
+            auto it = expected.find(key);
+            if (it == expected.end() || gen() % 2) {
+                REQUIRE(table.Inc(key) == ++expected[key]);
+            } else {
+                REQUIRE(table.Dec(key) == --it->second);
+                if (!it->second) {
+                    expected.erase(it);
+                }
+            }
+        }
+        for (auto& [key, count] : expected) {
+            REQUIRE(table.Count(key) == count);
+            while (count--) {
+                table.Dec(key);
+            }
+            REQUIRE(table.Count(key) == 0);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include "tagged_intrusive.h"
+
+#include <catch.hpp>
+
+struct Branch : SimpleRefCounted<Branch> {
+    explicit Branch(int value) : value(value) {
+        ++alive;
+    }
+    ~Branch() {
+        --alive;
+    }
+
+    int value;
+    inline static int alive = 0;
+};
+
+// A tagged pointer as a member of the type it points to
+struct Chain : SimpleRefCounted<Chain> {
+    TaggedIntrusivePtr<Chain, 1> child;
+};
+
+TEST_CASE("Tagged IntrusivePtr") {
+    enum Color : uintptr_t { kBlack = 0, kRed = 1 };
+    using Child = TaggedIntrusivePtr<Branch, 1>;
+    static_assert(sizeof(Child) == sizeof(void*));
+
+    SECTION("Copies share the object and the tag") {
+        Child red(MakeIntrusive<Branch>(1), kRed);
+        Child copy = red;
+        REQUIRE(copy == red);
+        REQUIRE(copy.GetTag() == kRed);
+        REQUIRE(red.UseCount() == 2);
+
+        copy.SetTag(kBlack);
+        REQUIRE(red.GetTag() == kRed);
+        REQUIRE(copy->value == 1);
+
+        IntrusivePtr<Branch> plain = copy.ToIntrusive();
+        REQUIRE(plain.UseCount() == 3);
+    }
+
+    SECTION("Reset keeps the tag") {
+        Child child(new Branch(1), kRed);
+        child.Reset(new Branch(2));
+        REQUIRE(Branch::alive == 1);
+        REQUIRE(child.GetTag() == kRed);
+        REQUIRE(child->value == 2);
+
+        Child moved = std::move(child);
+        REQUIRE(!child);
+        REQUIRE(moved.UseCount() == 1);
+        moved = nullptr;
+        REQUIRE(Branch::alive == 0);
+    }
+
+    SECTION("Self-referential node") {
+        static_assert(sizeof(Chain::child) == sizeof(void*));
+        auto root = MakeIntrusive<Chain>();
+        root->child = TaggedIntrusivePtr<Chain, 1>(MakeIntrusive<Chain>(), kRed);
+        REQUIRE(root->child.GetTag() == kRed);
+        REQUIRE(root->child.UseCount() == 1);
+        REQUIRE(!root->child->child);
+    }
+
+    REQUIRE(Branch::alive == 0);
+}
@@ -0,0 +1,42 @@
+#include "trailing_intrusive.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <string>
+#include <type_traits>
+
+struct Path : SimpleRefCounted<Path, TrailingDelete>, TrailingArray<Path, std::string> {
+    static inline int alive = 0;
+
+    explicit Path(bool absolute) : absolute(absolute) {
+        ++alive;
+    }
+    ~Path() {
+        --alive;
+    }
+
+    bool absolute;
+};
+
+TEST_CASE("Intrusive with trailing storage") {
+    static_assert(!std::is_copy_constructible_v<Path> && !std::is_move_assignable_v<Path>);
+
+    SECTION("One allocation") {
+        EXPECT_ONE_ALLOCATION(auto path = MakeIntrusiveWithTrailing<Path>(3, true));
+    }
+
+    SECTION("Lifetime") {
+        {
+            auto path = MakeIntrusiveWithTrailing<Path>(2, false);
+            path->Tail()[0] = "usr";
+            path->Tail()[1] = std::string(64, 'x');
+            IntrusivePtr<Path> copy = path;
+            REQUIRE(copy.UseCount() == 2);
+            REQUIRE(copy->TailSpan()[0] == "usr");
+            REQUIRE(!copy->absolute);
+        }
+        REQUIRE(Path::alive == 0);
+    }
+}
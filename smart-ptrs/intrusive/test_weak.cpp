@@ -0,0 +1,75 @@
+#include "intrusive_weak.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <string>
+
+struct Document : SimpleWeakRefCounted<Document> {
+    explicit Document(std::string title) : title(std::move(title)) {
+        ++alive;
+    }
+    ~Document() {
+        --alive;
+    }
+
+    std::string title;
+    inline static int alive = 0;
+};
+
+struct Draft : Document {
+    using Document::Document;
+};
+
+TEST_CASE("Intrusive weak pointers") {
+    static_assert(sizeof(Document) == sizeof(SimpleCounter) + sizeof(void*) + sizeof(std::string));
+    // Does not compile, the weak block is not thread-safe:
+    //     struct Shared : WeakRefCounted<Shared, AtomicCounter, DefaultDelete> {};
+
+    SECTION("No weak references, no weak block") {
+        auto doc = MakeIntrusive<Document>("a");
+        EXPECT_ZERO_ALLOCATIONS(IntrusivePtr<Document> copy = doc);
+    }
+
+    SECTION("Lock and expire") {
+        IntrusiveWeakPtr<Document> weak;
+        REQUIRE(weak.Expired());
+        REQUIRE(!weak.Lock());
+        {
+            auto doc = MakeIntrusive<Document>("title");
+            EXPECT_ONE_ALLOCATION(weak = doc);
+            EXPECT_ZERO_ALLOCATIONS(IntrusiveWeakPtr<Document> second = doc);
+            REQUIRE(weak.UseCount() == 1);
+            auto locked = weak.Lock();
+            REQUIRE(locked == doc);
+            REQUIRE(doc.UseCount() == 2);
+        }
+        REQUIRE(Document::alive == 0);
+        REQUIRE(weak.Expired());
+        REQUIRE(weak.UseCount() == 0);
+        REQUIRE(!weak.Lock());
+    }
+
+    SECTION("Weak pointers outlive each other") {
+        IntrusiveWeakPtr<Document> last;
+        {
+            IntrusivePtr<Draft> draft = MakeIntrusive<Draft>("draft");
+            IntrusiveWeakPtr<Draft> first = draft;
+            last = first;
+            REQUIRE(last.Lock()->title == "draft");
+        }
+        REQUIRE(last.Expired());
+        last.Reset();
+    }
+
+    SECTION("Copies are separate objects") {
+        auto doc = MakeIntrusive<Document>("original");
+        IntrusiveWeakPtr<Document> weak = doc;
+        auto copy = MakeIntrusive<Document>(*doc);
+        doc.Reset();
+        REQUIRE(weak.Expired());
+        IntrusiveWeakPtr<Document> copy_weak = copy;
+        REQUIRE(copy_weak.Lock()->title == "original");
+    }
+}
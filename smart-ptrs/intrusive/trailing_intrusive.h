@@ -0,0 +1,44 @@
+#pragma once
+
+#include "intrusive.h"
+
+#include <common/trailing.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Deleter for `RefCounted` objects made by `MakeIntrusiveWithTrailing`.
+struct TrailingDelete {
+    template <typename T>
+    static void Destroy(T* object) {
+        T::DestroyTail(object);
+        object->~T();
+        ::operator delete(object);
+    }
+};
+
+// `MakeIntrusive` for a `TrailingArray` type with `count` tail elements.
+// `T` has to release itself with `TrailingDelete`.
+template <typename T, typename Elem = typename T::TrailingElement, typename... Args>
+IntrusivePtr<T> MakeIntrusiveWithTrailing(size_t count, Args&&... args) {
+    static_assert(std::is_base_of_v<TrailingArray<T, Elem>, T>,
+                  "T must derive from TrailingArray<T, Elem>");
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "T is over-aligned");
+    void* memory = ::operator new(TrailingArray<T, Elem>::AllocationSize(count));
+    T* object;
+    SMART_PTRS_TRY {
+        object = ::new (memory) T(std::forward<Args>(args)...);
+    } SMART_PTRS_CATCH_ALL {
+        ::operator delete(memory);
+        SMART_PTRS_RETHROW;
+    }
+    SMART_PTRS_TRY {
+        T::ConstructTail(object, count);
+    } SMART_PTRS_CATCH_ALL {
+        object->~T();
+        ::operator delete(memory);
+        SMART_PTRS_RETHROW;
+    }
+    return IntrusivePtr<T>(object);
+}
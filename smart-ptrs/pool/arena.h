@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Bump allocator over a chain of blocks.
+// Memory is never given back one object at a time: `Reset()` rewinds to the first block in O(1)
+// and keeps the chain for the next round, the destructor frees everything.
+class Arena {
+    struct Block {
+        Block* next;
+        size_t size;  // usable bytes after the header
+
+        char* Begin() {
+            return reinterpret_cast<char*>(this + 1);
+        }
+        char* End() {
+            return Begin() + size;
+        }
+    };
+
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit Arena(size_t block_size = kDefaultBlockSize) : block_size_(block_size) {
+    }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() {
+        while (first_) {
+            Block* next = first_->next;
+            ::operator delete(first_);
+            first_ = next;
+        }
+    }
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        if (void* ptr = TryBump(size, alignment)) {
+            return ptr;
+        }
+        NextBlock(size, alignment);
+        return TryBump(size, alignment);
+    }
+
+    // Makes all memory handed out so far available again.
+    // Objects still living in the arena are not destroyed.
+    void Reset() {
+        current_ = first_;
+        if (current_) {
+            ptr_ = current_->Begin();
+        }
+        used_ = 0;
+    }
+
+    // Bytes handed out since the last `Reset`, alignment padding included.
+    size_t BytesUsed() const {
+        return used_;
+    }
+
+    // Bytes of all blocks in the chain.
+    size_t BytesReserved() const {
+        return reserved_;
+    }
+
+private:
+    void* TryBump(size_t size, size_t alignment) {
+        if (!current_) {
+            return nullptr;
+        }
+        uintptr_t addr = reinterpret_cast<uintptr_t>(ptr_);
+        uintptr_t aligned = (addr + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        uintptr_t end = reinterpret_cast<uintptr_t>(current_->End());
+        if (aligned > end || end - aligned < size) {
+            return nullptr;
+        }
+        used_ += aligned + size - addr;
+        ptr_ = reinterpret_cast<char*>(aligned + size);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Moves on to the next block that fits, reusing blocks retained by `Reset`.
+    void NextBlock(size_t size, size_t alignment) {
+        size_t need = size + alignment;
+        if (current_ && current_->next && current_->next->size >= need) {
+            current_ = current_->next;
+            ptr_ = current_->Begin();
+            return;
+        }
+        size_t block_size = need > block_size_ ? need : block_size_;
+        Block* block = static_cast<Block*>(::operator new(sizeof(Block) + block_size));
+        block->size = block_size;
+        reserved_ += block_size;
+        if (current_) {
+            block->next = current_->next;
+            current_->next = block;
+        } else {
+            block->next = first_;
+            first_ = block;
+        }
+        current_ = block;
+        ptr_ = block->Begin();
+    }
+
+    size_t block_size_;
+    Block* first_ = nullptr;
+    Block* current_ = nullptr;
+    char* ptr_ = nullptr;
+    size_t used_ = 0;
+    size_t reserved_ = 0;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <common/exceptions.h>
+
+#include <sys/mman.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Bump allocator over one contiguous reservation, unlike the block chain of `Arena`: every
+// address it hands out is a small offset from `Base()`. Pages are only backed once touched,
+// so reserving gigabytes up front costs address space, not memory.
+// The first byte is never handed out, offset 0 is free to mean null.
+// `Allocate` may be called from several threads at once, `Reset` only when no one allocates.
+class Region {
+public:
+    explicit Region(size_t capacity) : capacity_(capacity) {
+        void* base = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (base == MAP_FAILED) {
+            SMART_PTRS_THROW(std::bad_alloc());
+        }
+        base_ = static_cast<char*>(base);
+        Reset();
+    }
+    Region(const Region&) = delete;
+    Region& operator=(const Region&) = delete;
+    ~Region() {
+        munmap(base_, capacity_);
+    }
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        void* ptr = TryAllocate(size, alignment);
+        if (!ptr) {
+            SMART_PTRS_THROW(std::bad_alloc());
+        }
+        return ptr;
+    }
+
+    // nullptr when the reservation is exhausted
+    void* TryAllocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        size_t used = used_.load(std::memory_order_relaxed);
+        size_t aligned;
+        do {
+            aligned = (used + alignment - 1) & ~(alignment - 1);
+            if (aligned > capacity_ || capacity_ - aligned < size) {
+                return nullptr;
+            }
+        } while (!used_.compare_exchange_weak(used, aligned + size, std::memory_order_relaxed));
+        return base_ + aligned;
+    }
+
+    // Makes all memory handed out so far available again, the pages stay mapped.
+    // Objects still living in the region are not destroyed.
+    void Reset() {
+        used_.store(1, std::memory_order_relaxed);
+    }
+
+    char* Base() const {
+        return base_;
+    }
+    size_t Capacity() const {
+        return capacity_;
+    }
+    // Bytes handed out since the last `Reset`, alignment padding included.
+    size_t BytesUsed() const {
+        return used_.load(std::memory_order_relaxed) - 1;
+    }
+    bool Contains(const void* ptr) const {
+        return ptr >= base_ && ptr < base_ + capacity_;
+    }
+
+private:
+    char* base_ = nullptr;
+    size_t capacity_;
+    std::atomic<size_t> used_ = 1;
+};
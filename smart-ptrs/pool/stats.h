@@ -0,0 +1,218 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Point-in-time copy of the counters of one pool.
+struct PoolStats {
+    std::string name;
+    size_t allocations = 0;  // slots obtained from the system allocator
+    size_t reuses = 0;       // requests served from the free list
+    size_t misses = 0;       // requests that found the free list empty
+    size_t in_use = 0;
+    size_t peak_in_use = 0;
+    size_t available = 0;
+    size_t bytes_held = 0;  // bytes of all slots owned by the pool, in use or free
+};
+
+// Live counters embedded into a pool or an allocator.
+// Every instance links itself into the list of the thread that created it,
+// so `PoolRegistry::Snapshot()` sees all pools of the current thread without allocating.
+// Pools are thread-confined, so are the counters.
+class PoolCounters {
+    friend class PoolRegistry;
+
+public:
+    explicit PoolCounters(std::string name = "") : name_(std::move(name)) {
+        Link();
+    }
+    PoolCounters(const PoolCounters&) = delete;
+    PoolCounters& operator=(const PoolCounters&) = delete;
+    ~PoolCounters() {
+        Unlink();
+    }
+
+    // A request was served from the free list.
+    void OnReuse() {
+        ++reuses_;
+        --available_;
+        Acquired();
+    }
+    // A request found the free list empty and a new slot of `bytes` was allocated for it.
+    void OnMiss(size_t bytes) {
+        ++misses_;
+        ++allocations_;
+        bytes_held_ += bytes;
+        Acquired();
+    }
+    // A new slot of `bytes` was allocated straight into the free list.
+    void OnReserve(size_t bytes) {
+        ++allocations_;
+        ++available_;
+        bytes_held_ += bytes;
+    }
+    // A slot in use went back to the free list.
+    void OnRelease() {
+        --in_use_;
+        ++available_;
+    }
+    // A free slot of `bytes` was returned to the system allocator.
+    void OnFree(size_t bytes) {
+        --available_;
+        bytes_held_ -= bytes;
+    }
+
+    size_t NumAvailable() const {
+        return available_;
+    }
+    size_t NumInUse() const {
+        return in_use_;
+    }
+
+    PoolStats Snapshot() const {
+        PoolStats stats;
+        stats.name = name_;
+        stats.allocations = allocations_;
+        stats.reuses = reuses_;
+        stats.misses = misses_;
+        stats.in_use = in_use_;
+        stats.peak_in_use = peak_in_use_;
+        stats.available = available_;
+        stats.bytes_held = bytes_held_;
+        return stats;
+    }
+
+private:
+    void Acquired() {
+        if (++in_use_ > peak_in_use_) {
+            peak_in_use_ = in_use_;
+        }
+    }
+
+    static PoolCounters*& LocalHead() {
+        // Trivially destructible, so it is safe to unlink after thread-local destructors ran
+        static thread_local PoolCounters* head = nullptr;
+        return head;
+    }
+    void Link() {
+        head_ = &LocalHead();
+        next_ = *head_;
+        if (next_) {
+            next_->prev_ = this;
+        }
+        *head_ = this;
+    }
+    void Unlink() {
+        if (prev_) {
+            prev_->next_ = next_;
+        } else {
+            *head_ = next_;
+        }
+        if (next_) {
+            next_->prev_ = prev_;
+        }
+    }
+
+    std::string name_;
+    size_t allocations_ = 0;
+    size_t reuses_ = 0;
+    size_t misses_ = 0;
+    size_t in_use_ = 0;
+    size_t peak_in_use_ = 0;
+    size_t available_ = 0;
+    size_t bytes_held_ = 0;
+
+    PoolCounters** head_ = nullptr;
+    PoolCounters* prev_ = nullptr;
+    PoolCounters* next_ = nullptr;
+};
+
+// Access to the counters of all pools created by the current thread.
+class PoolRegistry {
+public:
+    static std::vector<PoolStats> Snapshot() {
+        std::vector<PoolStats> result;
+        for (PoolCounters* cur = PoolCounters::LocalHead(); cur; cur = cur->next_) {
+            result.push_back(cur->Snapshot());
+        }
+        return result;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Dumping
+
+enum class StatsFormat { kText, kJson };
+
+inline void WriteText(std::ostream& out, const PoolStats& stats) {
+    out << (stats.name.empty() ? "<unnamed>" : stats.name) << ": allocations=" << stats.allocations
+        << " reuses=" << stats.reuses << " misses=" << stats.misses << " in_use=" << stats.in_use
+        << " peak_in_use=" << stats.peak_in_use << " available=" << stats.available
+        << " bytes_held=" << stats.bytes_held << '\n';
+}
+
+inline void WriteJson(std::ostream& out, const PoolStats& stats) {
+    out << "{\"name\":\"";
+    for (char c : stats.name) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            static constexpr char kHex[] = "0123456789abcdef";
+            out << "\\u00" << kHex[c >> 4] << kHex[c & 0xf];
+        } else {
+            out << c;
+        }
+    }
+    out << "\",\"allocations\":" << stats.allocations << ",\"reuses\":" << stats.reuses
+        << ",\"misses\":" << stats.misses << ",\"in_use\":" << stats.in_use
+        << ",\"peak_in_use\":" << stats.peak_in_use << ",\"available\":" << stats.available
+        << ",\"bytes_held\":" << stats.bytes_held << '}';
+}
+
+inline void WriteStats(std::ostream& out, const std::vector<PoolStats>& all, StatsFormat format) {
+    if (format == StatsFormat::kText) {
+        for (const auto& stats : all) {
+            WriteText(out, stats);
+        }
+        return;
+    }
+    out << '[';
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (i) {
+            out << ',';
+        }
+        WriteJson(out, all[i]);
+    }
+    out << "]\n";
+}
+
+// Dumps the pools of the current thread at most once per `interval`.
+// There is no background thread: call `Tick()` from the thread's own loop.
+class StatsDumper {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    StatsDumper(std::ostream& out, StatsFormat format, Clock::duration interval)
+        : out_(out), format_(format), interval_(interval), last_(Clock::now()) {
+    }
+
+    // Returns true if a dump was written.
+    bool Tick(Clock::time_point now = Clock::now()) {
+        if (now - last_ < interval_) {
+            return false;
+        }
+        last_ = now;
+        WriteStats(out_, PoolRegistry::Snapshot(), format_);
+        return true;
+    }
+
+private:
+    std::ostream& out_;
+    StatsFormat format_;
+    Clock::duration interval_;
+    Clock::time_point last_;
+};
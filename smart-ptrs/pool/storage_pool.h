@@ -0,0 +1,133 @@
+#pragma once
+
+#include "stats.h"
+
+#include <common/exceptions.h>
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <utility>
+
+// Free list of raw storage slots for objects of type T.
+// Released slots are threaded through their own memory, so parking a slot never allocates.
+template <typename T>
+class StoragePool {
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+public:
+    static constexpr size_t kSlotSize = sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot);
+    static constexpr size_t kSlotAlign =
+        alignof(T) > alignof(FreeSlot) ? alignof(T) : alignof(FreeSlot);
+
+    explicit StoragePool(std::string name = "") : counters_(std::move(name)) {
+    }
+    StoragePool(const StoragePool&) = delete;
+    StoragePool& operator=(const StoragePool&) = delete;
+    // Objects still in use would hand their storage back to a dead pool
+    ~StoragePool() {
+        assert(NumInUse() == 0);
+        Trim();
+    }
+
+    // The pool of the calling thread.
+    static StoragePool& Local() {
+        static thread_local StoragePool pool;
+        return pool;
+    }
+
+    // Uninitialized storage for one T.
+    void* Acquire() {
+        if (free_) {
+            FreeSlot* slot = free_;
+            free_ = slot->next;
+            counters_.OnReuse();
+            return slot;
+        }
+        void* slot = AllocateSlot();
+        counters_.OnMiss(kSlotSize);
+        return slot;
+    }
+
+    // `Acquire` and construct a T in the slot. The request is counted once the constructor
+    // succeeded, on failure the slot goes to the free list.
+    template <typename... Args>
+    T* Construct(Args&&... args) {
+        bool reuse = free_;
+        void* slot = reuse ? std::exchange(free_, free_->next) : AllocateSlot();
+        T* object;
+        SMART_PTRS_TRY {
+            object = ::new (slot) T(std::forward<Args>(args)...);
+        } SMART_PTRS_CATCH_ALL {
+            free_ = ::new (slot) FreeSlot{free_};
+            if (!reuse) {
+                counters_.OnReserve(kSlotSize);
+            }
+            SMART_PTRS_RETHROW;
+        }
+        if (reuse) {
+            counters_.OnReuse();
+        } else {
+            counters_.OnMiss(kSlotSize);
+        }
+        return object;
+    }
+
+    // Takes back storage from `Acquire`, the object in it must be destroyed already.
+    void Release(void* ptr) {
+        assert(NumInUse() > 0 && "storage released into a pool it did not come from");
+        free_ = ::new (ptr) FreeSlot{free_};
+        counters_.OnRelease();
+    }
+
+    void Reserve(size_t count) {
+        while (count--) {
+            free_ = ::new (AllocateSlot()) FreeSlot{free_};
+            counters_.OnReserve(kSlotSize);
+        }
+    }
+
+    // Give all free slots back to the system allocator.
+    void Trim() {
+        while (free_) {
+            FreeSlot* slot = free_;
+            free_ = slot->next;
+            FreeSlotMemory(slot);
+            counters_.OnFree(kSlotSize);
+        }
+    }
+
+    size_t NumAvailable() const {
+        return counters_.NumAvailable();
+    }
+
+    size_t NumInUse() const {
+        return counters_.NumInUse();
+    }
+
+    PoolStats Stats() const {
+        return counters_.Snapshot();
+    }
+
+private:
+    static void* AllocateSlot() {
+        if constexpr (kSlotAlign > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(kSlotSize, std::align_val_t(kSlotAlign));
+        } else {
+            return ::operator new(kSlotSize);
+        }
+    }
+    static void FreeSlotMemory(void* ptr) {
+        if constexpr (kSlotAlign > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(ptr, std::align_val_t(kSlotAlign));
+        } else {
+            ::operator delete(ptr);
+        }
+    }
+
+    FreeSlot* free_ = nullptr;
+    PoolCounters counters_;
+};
@@ -0,0 +1,89 @@
+#include "stats.h"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <thread>
+
+TEST_CASE("Pool counters") {
+    PoolCounters counters("messages");
+    counters.OnReserve(16);
+    counters.OnReuse();
+    counters.OnMiss(16);
+    counters.OnMiss(16);
+    counters.OnRelease();
+    counters.OnRelease();
+    counters.OnFree(16);
+
+    auto stats = counters.Snapshot();
+    REQUIRE(stats.name == "messages");
+    REQUIRE(stats.allocations == 3);
+    REQUIRE(stats.reuses == 1);
+    REQUIRE(stats.misses == 2);
+    REQUIRE(stats.in_use == 1);
+    REQUIRE(stats.peak_in_use == 3);
+    REQUIRE(stats.available == 1);
+    REQUIRE(stats.bytes_held == 32);
+}
+
+TEST_CASE("Per thread registry") {
+    REQUIRE(PoolRegistry::Snapshot().empty());
+    {
+        PoolCounters a("a");
+        {
+            PoolCounters b("b");
+            PoolCounters c("c");
+            REQUIRE(PoolRegistry::Snapshot().size() == 3);
+        }
+        auto all = PoolRegistry::Snapshot();
+        REQUIRE(all.size() == 1);
+        REQUIRE(all[0].name == "a");
+
+        std::thread([] {
+            PoolCounters other("other");
+            auto all = PoolRegistry::Snapshot();
+            REQUIRE(all.size() == 1);
+            REQUIRE(all[0].name == "other");
+        }).join();
+    }
+    REQUIRE(PoolRegistry::Snapshot().empty());
+}
+
+TEST_CASE("Dump") {
+    PoolCounters counters("say \"hi\"");
+    counters.OnMiss(8);
+
+    SECTION("Text") {
+        std::ostringstream out;
+        WriteStats(out, PoolRegistry::Snapshot(), StatsFormat::kText);
+        REQUIRE(out.str() ==
+                "say \"hi\": allocations=1 reuses=0 misses=1 in_use=1 peak_in_use=1 available=0 "
+                "bytes_held=8\n");
+    }
+
+    SECTION("Json") {
+        std::ostringstream out;
+        WriteStats(out, PoolRegistry::Snapshot(), StatsFormat::kJson);
+        REQUIRE(out.str() ==
+                "[{\"name\":\"say \\\"hi\\\"\",\"allocations\":1,\"reuses\":0,\"misses\":1,"
+                "\"in_use\":1,\"peak_in_use\":1,\"available\":0,\"bytes_held\":8}]\n");
+    }
+
+    SECTION("Json control characters") {
+        PoolCounters tabbed("a\tb\n\x01");
+        std::ostringstream out;
+        WriteJson(out, tabbed.Snapshot());
+        REQUIRE(out.str().starts_with("{\"name\":\"a\\u0009b\\u000a\\u0001\","));
+    }
+
+    SECTION("Periodic") {
+        std::ostringstream out;
+        auto start = StatsDumper::Clock::now();
+        StatsDumper dumper(out, StatsFormat::kText, std::chrono::seconds(10));
+        REQUIRE(!dumper.Tick(start + std::chrono::seconds(1)));
+        REQUIRE(out.str().empty());
+        REQUIRE(dumper.Tick(start + std::chrono::seconds(11)));
+        REQUIRE(!out.str().empty());
+        REQUIRE(!dumper.Tick(start + std::chrono::seconds(12)));
+    }
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "shared.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <span>
+#include <string_view>
+#include <utility>
+
+// Control block with the payload bytes right behind it: one allocation per buffer.
+class CBlockBuffer : public BaseBlock {
+public:
+    static CBlockBuffer* Create(size_t capacity) {
+        void* memory = ::operator new(sizeof(CBlockBuffer) + capacity);
+        return ::new (memory) CBlockBuffer(capacity);
+    }
+
+    // Matches the unsized allocation in `Create`, `delete block_` ends up here
+    static void operator delete(void* ptr) {
+        ::operator delete(ptr);
+    }
+
+    void DecStrongCounter() override {
+        // Bytes need no destruction, the memory goes away with the block
+        strong_counter_ -= 1;
+    }
+
+    std::byte* Data() {
+        return reinterpret_cast<std::byte*>(this + 1);
+    }
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+private:
+    explicit CBlockBuffer(size_t capacity) : capacity_(capacity) {
+    }
+
+    size_t capacity_;
+};
+
+// Reference counted byte range. Copies, `Slice` and `Split` share the block,
+// writes through `MutableData` copy the range first if anyone else can see it.
+class SharedBuffer {
+public:
+    SharedBuffer() = default;
+
+    // `size` uninitialized bytes.
+    explicit SharedBuffer(size_t size) : size_(size) {
+        if (size) {
+            CBlockBuffer* block = CBlockBuffer::Create(size);
+            data_ = SharedFromBlock(block, block->Data());
+        }
+    }
+
+    SharedBuffer(const SharedBuffer&) = default;
+    SharedBuffer(SharedBuffer&& other)
+        : data_(std::move(other.data_)), size_(std::exchange(other.size_, 0)) {
+    }
+    SharedBuffer& operator=(const SharedBuffer&) = default;
+    SharedBuffer& operator=(SharedBuffer&& other) {
+        data_ = std::move(other.data_);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    static SharedBuffer Copy(std::span<const std::byte> bytes) {
+        SharedBuffer buffer(bytes.size());
+        if (!bytes.empty()) {
+            std::memcpy(buffer.data_.Get(), bytes.data(), bytes.size());
+        }
+        return buffer;
+    }
+    static SharedBuffer Copy(std::string_view str) {
+        return Copy(std::as_bytes(std::span(str.data(), str.size())));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Zero-copy views
+
+    // Clamped to the end of this buffer.
+    SharedBuffer Slice(size_t offset, size_t length = SIZE_MAX) const {
+        if (offset > size_) {
+            offset = size_;
+        }
+        if (length > size_ - offset) {
+            length = size_ - offset;
+        }
+        return SharedBuffer(SharedPtr<std::byte>(data_, data_.Get() + offset), length);
+    }
+
+    // Cuts off the first `at` bytes and returns them, this buffer keeps the rest.
+    SharedBuffer Split(size_t at) {
+        SharedBuffer front = Slice(0, at);
+        *this = Slice(front.Size());
+        return front;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    const std::byte* Data() const {
+        return data_.Get();
+    }
+    size_t Size() const {
+        return size_;
+    }
+    bool Empty() const {
+        return !size_;
+    }
+    std::span<const std::byte> Span() const {
+        return {Data(), size_};
+    }
+    std::string_view View() const {
+        return {reinterpret_cast<const char*>(Data()), size_};
+    }
+    size_t UseCount() const {
+        return data_.UseCount();
+    }
+
+    // Write access. Copies the viewed range into a private block if the current one is shared.
+    std::byte* MutableData() {
+        if (data_.UseCount() > 1) {
+            *this = Copy(Span());
+        }
+        return data_.Get();
+    }
+
+private:
+    SharedBuffer(SharedPtr<std::byte> data, size_t size) : data_(std::move(data)), size_(size) {
+    }
+
+    SharedPtr<std::byte> data_;
+    size_t size_ = 0;
+};
+
+// Sequence of buffers treated as one byte stream. Appending and splitting move
+// references around, bytes are only copied by `Coalesce` when there is more than one segment.
+class BufferChain {
+public:
+    void Append(SharedBuffer buffer) {
+        if (!buffer.Empty()) {
+            size_ += buffer.Size();
+            segments_.push_back(std::move(buffer));
+        }
+    }
+    void Append(BufferChain&& other) {
+        for (auto& segment : other.segments_) {
+            Append(std::move(segment));
+        }
+        other.Clear();
+    }
+
+    // Cuts off the first `at` bytes and returns them, the chain keeps the rest.
+    BufferChain Split(size_t at) {
+        BufferChain front;
+        while (at && !segments_.empty()) {
+            SharedBuffer& head = segments_.front();
+            if (head.Size() <= at) {
+                at -= head.Size();
+                size_ -= head.Size();
+                front.Append(std::move(head));
+                segments_.pop_front();
+            } else {
+                size_ -= at;
+                front.Append(head.Split(at));
+                at = 0;
+            }
+        }
+        return front;
+    }
+
+    // The whole chain as one contiguous buffer.
+    SharedBuffer Coalesce() const {
+        if (segments_.size() == 1) {
+            return segments_.front();
+        }
+        SharedBuffer result(size_);
+        std::byte* out = result.MutableData();
+        for (const auto& segment : segments_) {
+            std::memcpy(out, segment.Data(), segment.Size());
+            out += segment.Size();
+        }
+        return result;
+    }
+
+    void Clear() {
+        segments_.clear();
+        size_ = 0;
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+    bool Empty() const {
+        return !size_;
+    }
+    size_t NumSegments() const {
+        return segments_.size();
+    }
+    const std::deque<SharedBuffer>& Segments() const {
+        return segments_;
+    }
+
+private:
+    std::deque<SharedBuffer> segments_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "shared.h"
+#include "weak.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// LRU cache holding strong references within an entry and byte budget.
+// Evicted values stay reachable through a weak reference for as long as someone
+// else still holds them, so looking up an object in use never reloads it.
+// Such an entry pins the control block, and with `MakeShared` the storage of the value,
+// until it is forgotten: a small sweep step on every insertion drops the expired ones,
+// `Sweep()` all of them at once.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class SharedCache {
+    struct Entry {
+        SharedPtr<V> strong;  // empty once evicted
+        WeakPtr<V> weak;
+        size_t bytes = 0;
+        typename std::list<K>::iterator lru;  // in `lru_` while `strong` is set, else `evicted_`
+    };
+
+public:
+    static constexpr size_t kSweepStep = 2;  // evicted entries checked per insertion
+
+    struct Stats {
+        size_t hits = 0;       // served from a strong entry
+        size_t weak_hits = 0;  // evicted, but still alive elsewhere
+        size_t misses = 0;
+    };
+
+    SharedCache(size_t max_entries, size_t max_bytes = SIZE_MAX)
+        : max_entries_(max_entries), max_bytes_(max_bytes) {
+    }
+
+    SharedPtr<V> Get(const K& key) {
+        auto it = map_.find(key);
+        if (it == map_.end()) {
+            ++stats_.misses;
+            return SharedPtr<V>();
+        }
+        Entry& entry = it->second;
+        if (entry.strong) {
+            ++stats_.hits;
+            lru_.splice(lru_.begin(), lru_, entry.lru);
+            return entry.strong;
+        }
+        SharedPtr<V> alive = entry.weak.Lock();
+        if (!alive) {
+            ++stats_.misses;
+            Forget(it);
+            return alive;
+        }
+        ++stats_.weak_hits;
+        Promote(it, alive);
+        return alive;
+    }
+
+    // `Get`, falling back to `load()` and caching its result of `bytes` size.
+    // An empty result means "not found" and is not cached, the next call loads again.
+    template <typename Load>
+    SharedPtr<V> GetOrLoad(const K& key, Load load, size_t bytes = sizeof(V)) {
+        if (auto found = Get(key)) {
+            return found;
+        }
+        SharedPtr<V> value = load();
+        if (value) {
+            Put(key, value, bytes);
+        }
+        return value;
+    }
+
+    // Putting an empty pointer is the same as `Erase`: only values are cached.
+    void Put(const K& key, SharedPtr<V> value, size_t bytes = sizeof(V)) {
+        if (!value) {
+            Erase(key);
+            return;
+        }
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            Demote(it->second);
+        } else {
+            it = map_.emplace(key, Entry()).first;
+            it->second.lru = evicted_.insert(evicted_.end(), key);
+        }
+        it->second.bytes = bytes;
+        it->second.weak = value;
+        Promote(it, std::move(value));
+    }
+
+    void Erase(const K& key) {
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            Demote(it->second);
+            Forget(it);
+        }
+    }
+
+    // Forgets evicted entries whose values died.
+    void Sweep() {
+        for (auto it = map_.begin(); it != map_.end();) {
+            if (!it->second.strong && it->second.weak.Expired()) {
+                evicted_.erase(it->second.lru);
+                it = map_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Values held strongly by the cache.
+    size_t NumStrong() const {
+        return lru_.size();
+    }
+    // All tracked keys, evicted ones included.
+    size_t Size() const {
+        return map_.size();
+    }
+    size_t Bytes() const {
+        return bytes_;
+    }
+    const Stats& GetStats() const {
+        return stats_;
+    }
+
+private:
+    using Iterator = typename std::unordered_map<K, Entry, Hash>::iterator;
+
+    void Promote(Iterator it, SharedPtr<V> value) {
+        Entry& entry = it->second;
+        entry.strong = std::move(value);
+        lru_.splice(lru_.begin(), evicted_, entry.lru);
+        bytes_ += entry.bytes;
+        Evict(it);
+        SweepStep();
+    }
+
+    void Demote(Entry& entry) {
+        if (entry.strong) {
+            entry.strong.Reset();
+            evicted_.splice(evicted_.end(), lru_, entry.lru);
+            bytes_ -= entry.bytes;
+        }
+    }
+
+    // Drops a demoted entry.
+    void Forget(Iterator it) {
+        evicted_.erase(it->second.lru);
+        map_.erase(it);
+    }
+
+    // Checks the oldest evicted entries, survivors go to the back of the queue.
+    void SweepStep() {
+        for (size_t i = 0; i < kSweepStep && !evicted_.empty(); ++i) {
+            auto it = map_.find(evicted_.front());
+            if (it->second.weak.Expired()) {
+                Forget(it);
+            } else {
+                evicted_.splice(evicted_.end(), evicted_, evicted_.begin());
+            }
+        }
+    }
+
+    // Drops least recently used strong references until within budget, never `keep`.
+    void Evict(Iterator keep) {
+        while (lru_.size() > 1 && (lru_.size() > max_entries_ || bytes_ > max_bytes_)) {
+            auto victim = map_.find(lru_.back());
+            if (victim == keep) {
+                break;
+            }
+            Demote(victim->second);
+            if (victim->second.weak.Expired()) {
+                Forget(victim);
+            }
+        }
+    }
+
+    size_t max_entries_;
+    size_t max_bytes_;
+    size_t bytes_ = 0;
+    std::list<K> lru_;  // front is the most recently used
+    std::list<K> evicted_;  // weak-only entries, front is the next to check
+    std::unordered_map<K, Entry, Hash> map_;
+    Stats stats_;
+};
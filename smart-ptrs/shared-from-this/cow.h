@@ -0,0 +1,82 @@
+#pragma once
+
+#include "shared.h"
+
+#include <cassert>
+#include <utility>
+
+// Shares one immutable value between copies until someone writes.
+// The value never escapes as a mutable shared pointer, so a use count of one and no weak
+// references mean the writer is the only owner and may mutate in place. A `WeakPtr` taken
+// from a `Share()` view could lock the value later, so while one exists writes clone.
+template <typename T>
+class CowPtr {
+    template <typename Y, typename... Args>
+    friend CowPtr<Y> MakeCow(Args&&... args);
+
+public:
+    CowPtr() = default;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    // Clones the value first if it is shared or weakly referenced. The pointer must not be empty.
+    // Counters are not atomic yet: a CowPtr and its copies must stay on one thread.
+    // With atomic counters this check has to load the count with acquire ordering,
+    // so that writes made through other owners before they released are visible here.
+    T& Write() {
+        assert(ptr_ && "Write on an empty CowPtr");
+        if (IsShared()) {
+            ptr_ = MakeShared<T>(std::as_const(*ptr_));
+        }
+        return *ptr_;
+    }
+
+    void Reset() {
+        ptr_.Reset();
+    }
+    void Swap(CowPtr& other) {
+        ptr_.Swap(other.ptr_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    const T& Read() const {
+        return *ptr_;
+    }
+    const T* Get() const {
+        return ptr_.Get();
+    }
+    const T& operator*() const {
+        return *ptr_;
+    }
+    const T* operator->() const {
+        return ptr_.Get();
+    }
+    size_t UseCount() const {
+        return ptr_.UseCount();
+    }
+    // Whether a write has to clone
+    bool IsShared() const {
+        return ptr_.UseCount() > 1 || ptr_.WeakCount() > 0;
+    }
+    explicit operator bool() const {
+        return static_cast<bool>(ptr_);
+    }
+
+    // Read-only shared view of the current value. Counts as an owner, later writes will clone.
+    SharedPtr<const T> Share() const {
+        return ptr_;
+    }
+
+private:
+    SharedPtr<T> ptr_;
+};
+
+template <typename T, typename... Args>
+CowPtr<T> MakeCow(Args&&... args) {
+    CowPtr<T> cow;
+    cow.ptr_ = MakeShared<T>(std::forward<Args>(args)...);
+    return cow;
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "shared.h"
+#include "weak.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Deduplicates equal immutable values. The table only holds weak references,
+// so a value lives exactly as long as someone outside uses it.
+// Expired entries are dropped when a lookup runs into them and by a small
+// sweep step on every insertion, `Sweep()` drops all of them at once.
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+class Interner {
+    struct Entry {
+        size_t hash;
+        WeakPtr<const T> weak;
+    };
+    using Bucket = std::vector<Entry>;
+
+public:
+    static constexpr size_t kSweepStep = 2;  // buckets swept per insertion
+
+    explicit Interner(size_t buckets = 16) : buckets_(buckets ? buckets : 1) {
+    }
+
+    SharedPtr<const T> Intern(const T& value) {
+        return DoIntern(value, [&] { return MakeShared<T>(value); });
+    }
+    SharedPtr<const T> Intern(T&& value) {
+        return DoIntern(value, [&] { return MakeShared<T>(std::move(value)); });
+    }
+
+    // Existing value equal to `value`, or an empty pointer.
+    SharedPtr<const T> Find(const T& value) {
+        size_t hash = Hash()(value);
+        return Lookup(BucketFor(hash), hash, value);
+    }
+
+    // Drops every expired entry.
+    void Sweep() {
+        for (auto& bucket : buckets_) {
+            SweepBucket(bucket);
+        }
+    }
+
+    // Entries in the table, expired ones not swept yet included.
+    size_t Size() const {
+        return size_;
+    }
+    size_t BucketCount() const {
+        return buckets_.size();
+    }
+
+private:
+    template <typename Create>
+    SharedPtr<const T> DoIntern(const T& value, Create create) {
+        size_t hash = Hash()(value);
+        Bucket& bucket = BucketFor(hash);
+        if (auto found = Lookup(bucket, hash, value)) {
+            return found;
+        }
+        SharedPtr<const T> result = create();
+        bucket.push_back(Entry{hash, WeakPtr<const T>(result)});
+        ++size_;
+        SweepStep();
+        ++inserts_since_sweep_;
+        // Grow only for live entries, a table full of expired ones is purged instead. Full
+        // sweeps are at least one insertion per bucket apart, so a live set churning around
+        // the limit costs O(1) per insertion amortized and the load factor stays below 3.
+        if (size_ > 2 * buckets_.size() && inserts_since_sweep_ >= buckets_.size()) {
+            Sweep();
+            inserts_since_sweep_ = 0;
+            if (size_ > 2 * buckets_.size()) {
+                Rehash(2 * buckets_.size());
+            }
+        }
+        return result;
+    }
+
+    SharedPtr<const T> Lookup(Bucket& bucket, size_t hash, const T& value) {
+        for (size_t i = 0; i < bucket.size();) {
+            if (bucket[i].weak.Expired()) {
+                Erase(bucket, i);
+                continue;
+            }
+            if (bucket[i].hash == hash) {
+                SharedPtr<const T> locked = bucket[i].weak.Lock();
+                if (Equal()(*locked, value)) {
+                    return locked;
+                }
+            }
+            ++i;
+        }
+        return SharedPtr<const T>();
+    }
+
+    void SweepStep() {
+        for (size_t i = 0; i < kSweepStep; ++i) {
+            SweepBucket(buckets_[cursor_]);
+            cursor_ = (cursor_ + 1) % buckets_.size();
+        }
+    }
+
+    void SweepBucket(Bucket& bucket) {
+        for (size_t i = 0; i < bucket.size();) {
+            if (bucket[i].weak.Expired()) {
+                Erase(bucket, i);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    void Erase(Bucket& bucket, size_t i) {
+        std::swap(bucket[i], bucket.back());
+        bucket.pop_back();
+        --size_;
+    }
+
+    // Expired entries are not carried over.
+    void Rehash(size_t count) {
+        std::vector<Bucket> buckets(count);
+        size_t size = 0;
+        for (auto& bucket : buckets_) {
+            for (auto& entry : bucket) {
+                if (!entry.weak.Expired()) {
+                    buckets[entry.hash % count].push_back(std::move(entry));
+                    ++size;
+                }
+            }
+        }
+        buckets_ = std::move(buckets);
+        size_ = size;
+        cursor_ = 0;
+        inserts_since_sweep_ = 0;
+    }
+
+    Bucket& BucketFor(size_t hash) {
+        return buckets_[hash % buckets_.size()];
+    }
+
+    std::vector<Bucket> buckets_;
+    size_t size_ = 0;
+    size_t cursor_ = 0;
+    size_t inserts_since_sweep_ = 0;
+};
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "shared.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <system_error>
+
+// Read-only view of a memory-mapped file. All views share one control block
+// whose deleter unmaps the file when the last of them goes away.
+class MappedFile {
+public:
+    enum class Access { kNormal, kSequential, kRandom, kWillNeed, kDontNeed };
+
+    MappedFile() = default;
+
+    // Throws std::system_error if the file cannot be opened or mapped.
+    static MappedFile Open(const std::string& path) {
+        std::error_code error;
+        MappedFile file = Open(path, error);
+        if (error) {
+            SMART_PTRS_THROW(std::system_error(error, "map " + path));
+        }
+        return file;
+    }
+
+    // Empty view and `error` set if the file cannot be opened or mapped.
+    static MappedFile Open(const std::string& path, std::error_code& error) {
+        error.clear();
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            error.assign(errno, std::generic_category());
+            return MappedFile();
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            error.assign(errno, std::generic_category());
+            ::close(fd);
+            return MappedFile();
+        }
+        size_t size = st.st_size;
+        if (!size) {
+            ::close(fd);
+            return MappedFile();
+        }
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            error.assign(errno, std::generic_category());
+        }
+        // The mapping keeps its own reference to the file
+        ::close(fd);
+        if (error) {
+            return MappedFile();
+        }
+        auto* data = static_cast<const std::byte*>(addr);
+        return MappedFile(SharedPtr<const std::byte>(data, Unmap{size}), size);
+    }
+
+    // Zero-copy sub-view, clamped to the end of this one. Keeps the whole mapping alive.
+    MappedFile Slice(size_t offset, size_t length = SIZE_MAX) const {
+        if (offset > size_) {
+            offset = size_;
+        }
+        if (length > size_ - offset) {
+            length = size_ - offset;
+        }
+        return MappedFile(SharedPtr<const std::byte>(data_, data_.Get() + offset), length);
+    }
+
+    // Readahead hint for the pages under this view. Returns false if the kernel rejected it.
+    bool Advise(Access access) const {
+        if (!size_) {
+            return true;
+        }
+        static const uintptr_t kPageSize = sysconf(_SC_PAGESIZE);
+        uintptr_t begin = reinterpret_cast<uintptr_t>(Data()) / kPageSize * kPageSize;
+        uintptr_t end = reinterpret_cast<uintptr_t>(Data()) + size_;
+        return madvise(reinterpret_cast<void*>(begin), end - begin, ToAdvice(access)) == 0;
+    }
+
+    const std::byte* Data() const {
+        return data_.Get();
+    }
+    size_t Size() const {
+        return size_;
+    }
+    std::span<const std::byte> Span() const {
+        return {Data(), size_};
+    }
+
+    // Owner of the bytes, usable wherever a plain shared pointer is expected.
+    const SharedPtr<const std::byte>& Owner() const {
+        return data_;
+    }
+    size_t UseCount() const {
+        return data_.UseCount();
+    }
+
+private:
+    struct Unmap {
+        size_t size;
+
+        void operator()(const std::byte* ptr) const {
+            munmap(const_cast<std::byte*>(ptr), size);
+        }
+    };
+
+    MappedFile(SharedPtr<const std::byte> data, size_t size) : data_(std::move(data)), size_(size) {
+    }
+
+    static int ToAdvice(Access access) {
+        switch (access) {
+            case Access::kSequential:
+                return MADV_SEQUENTIAL;
+            case Access::kRandom:
+                return MADV_RANDOM;
+            case Access::kWillNeed:
+                return MADV_WILLNEED;
+            case Access::kDontNeed:
+                return MADV_DONTNEED;
+            default:
+                return MADV_NORMAL;
+        }
+    }
+
+    SharedPtr<const std::byte> data_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,51 @@
+// Compiled with -fno-exceptions: instantiates the throwing paths of every header in this directory.
+
+#include "buffer.h"
+#include "cache.h"
+#include "cow.h"
+#include "interner.h"
+#include "mapped_file.h"
+#include "owner.h"
+#include "shared.h"
+#include "thin.h"
+#include "trailing_shared.h"
+#include "weak.h"
+
+#include <string>
+
+struct SharedNode : EnableSharedFromThis<SharedNode> {};
+
+struct LeanNode : EnableSharedFromBlock<LeanNode> {};
+
+struct BareNode : EnableSharedFromAddress<BareNode> {};
+
+struct SharedLabel : TrailingArray<SharedLabel, char> {};
+
+void CheckSharedNoExceptions() {
+    auto node = MakeShared<SharedNode>();
+    WeakPtr<SharedNode> weak = node;
+    SharedPtr<SharedNode> locked(weak);
+    SharedPtr<SharedNode> tried = weak.TryLock();
+    SharedPtr<SharedNode> self = node->TrySharedFromThis();
+    SharedPtr<SharedNode> split = MakeSharedWithLayout<SharedNode, SharedLayout::kSplit>();
+    SharedPtr<LeanNode> lean = MakeShared<LeanNode>()->SharedFromThis();
+    SharedPtr<BareNode> bare = MakeShared<BareNode>()->SharedFromThis();
+    SharedPtr<int> deleted(new int(1), [](int* ptr) { delete ptr; });
+    auto thin = MakeThinShared<std::string>("thin");
+
+    auto label = MakeSharedWithTrailing<SharedLabel>(4);
+    auto cow = MakeCow<std::string>("cow");
+    cow.Write().append("!");
+
+    std::error_code error;
+    auto file = MappedFile::Open("/dev/null", error);
+
+    BufferChain chain;
+    chain.Append(SharedBuffer::Copy("bytes"));
+    auto whole = chain.Coalesce();
+
+    Interner<std::string> interner;
+    auto interned = interner.Intern(std::string("interned"));
+    SharedCache<int, std::string> cache(16, 1024);
+    auto cached = cache.Get(1);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "shared.h"
+#include "weak.h"
+
+#include <functional>
+
+// Hashing and ordering by owner (control block) rather than by stored pointer.
+// Keys stay stable after the object expires and never collide through address reuse:
+// a block is not freed while a `WeakPtr` to it exists.
+// Mix `SharedPtr` and `WeakPtr` freely, e.g. look up a `WeakPtr` key with a `SharedPtr`.
+
+struct OwnerHash {
+    using is_transparent = void;
+
+    template <typename P>
+    size_t operator()(const P& ptr) const {
+        return std::hash<const void*>()(ptr.OwnerId());
+    }
+};
+
+struct OwnerEqual {
+    using is_transparent = void;
+
+    template <typename P, typename Q>
+    bool operator()(const P& left, const Q& right) const {
+        return left.OwnerId() == right.OwnerId();
+    }
+};
+
+struct OwnerLess {
+    using is_transparent = void;
+
+    template <typename P, typename Q>
+    bool operator()(const P& left, const Q& right) const {
+        return std::less<const void*>()(left.OwnerId(), right.OwnerId());
+    }
+};
@@ -2,40 +2,203 @@
 
 #include "sw_fwd.h"  // Forward declaration
 
+#include <common/tagged.h>
+
+#include <cassert>
 #include <cstddef>  // std::nullptr_t
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Types that are never observed by `WeakPtr` can opt out of weak references, either by deriving
+// from `StrongOnlyBase` or by specializing `IsStrongOnly`. Their control blocks have no weak
+// counter and dropping a reference is one decrement. Naming `WeakPtr<T>` does not compile.
+// The trait has to agree along pointer conversions: converting and aliasing `SharedPtr<T>` from
+// `SharedPtr<Y>` do not compile when only one of `T` and `Y` is strong-only, the control blocks
+// differ. `WeakPtr`-based mixins are unavailable.
+// A specialization has to be visible wherever `SharedPtr<T>` is used, the block layout depends on it.
+struct StrongOnlyBase {};
 
-// https://en.cppreference.com/w/cpp/memory/shared_ptr
-class BaseBlock {
+template <typename T>
+struct IsStrongOnly : std::is_convertible<T*, StrongOnlyBase*> {};
+
+template <typename T>
+inline constexpr bool kStrongOnly = IsStrongOnly<std::remove_cv_t<T>>::value;
+
+// Strong half of a control block, all that `StrongOnly` types get.
+class StrongBlock {
 protected:
     size_t strong_counter_ = 1;
-    size_t weak_counter_ = 0;
 
 public:
-    BaseBlock() = default;
+    // Strong counts from here on mark an immortal object: references are not counted,
+    // the object and its block are never destroyed.
+    static constexpr size_t kImmortal = size_t(1) << (sizeof(size_t) * 8 - 1);
+
+    StrongBlock() = default;
     virtual void IncStrongCounter() {
-        strong_counter_++;
+        if (!IsImmortal()) {
+            strong_counter_++;
+        }
     }
-    virtual void IncWeakCounter() {
-        weak_counter_++;
+    // Increment only if the object is still alive: checking and taking the reference is one step,
+    // which stays correct once the counter becomes atomic.
+    bool TryIncStrongCounter() {
+        if (!strong_counter_) {
+            return false;
+        }
+        if (!IsImmortal()) {
+            strong_counter_++;
+        }
+        return true;
     }
     virtual void DecStrongCounter() = 0;
-    virtual void DecWeakCounter() {
-        weak_counter_--;
-    }
     // virtual T* GetObjPtr() = 0;
-    virtual ~BaseBlock() {
+    virtual ~StrongBlock() {
     }
 
     size_t GetStrongCounter() {
         return strong_counter_;
     }
+
+    bool IsImmortal() const {
+        return strong_counter_ >= kImmortal;
+    }
+    // Pins the object for the rest of the process, whoever holds references.
+    void MakeImmortal() {
+        strong_counter_ = kImmortal;
+    }
+
+    // Destroys the object and the block with the last reference.
+    static void ReleaseStrong(StrongBlock* block) {
+        if (block->IsImmortal()) {
+            return;
+        }
+        block->DecStrongCounter();
+        if (!block->strong_counter_) {
+            delete block;
+        }
+    }
+};
+
+// https://en.cppreference.com/w/cpp/memory/shared_ptr
+class BaseBlock : public StrongBlock {
+protected:
+    size_t weak_counter_ = 0;
+
+public:
+    BaseBlock() = default;
+    virtual void IncWeakCounter() {
+        weak_counter_++;
+    }
+    virtual void DecWeakCounter() {
+        weak_counter_--;
+    }
+
     size_t GetWeakCounter() {
-        return weak_counter_;
+        return weak_counter_ & ~kHasListeners;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Expiry listeners
+    // Kept in a side table, a block only carries a flag bit in `weak_counter_`,
+    // so blocks without listeners pay nothing but one test when the last strong reference goes.
+
+    // Returns an id for `RemoveExpiryListener`, 0 if the block has expired already.
+    size_t AddExpiryListener(std::function<void()> callback) {
+        if (!strong_counter_) {
+            return 0;
+        }
+        static size_t last_id = 0;
+        ExpiryTable()[this].push_back({++last_id, std::move(callback)});
+        weak_counter_ |= kHasListeners;
+        return last_id;
+    }
+    void RemoveExpiryListener(size_t id) {
+        if (!HasExpiryListeners()) {
+            return;
+        }
+        auto it = ExpiryTable().find(this);
+        auto& listeners = it->second;
+        for (size_t i = 0; i < listeners.size(); ++i) {
+            if (listeners[i].id == id) {
+                listeners.erase(listeners.begin() + i);
+                break;
+            }
+        }
+        if (listeners.empty()) {
+            ExpiryTable().erase(it);
+            weak_counter_ &= ~kHasListeners;
+        }
+    }
+    bool HasExpiryListeners() const {
+        return weak_counter_ & kHasListeners;
+    }
+    // Fires and forgets all listeners. Called with the strong counter at zero,
+    // while a weak reference still keeps the block alive.
+    void NotifyExpired() {
+        auto it = ExpiryTable().find(this);
+        auto listeners = std::move(it->second);
+        ExpiryTable().erase(it);
+        weak_counter_ &= ~kHasListeners;
+        for (auto& listener : listeners) {
+            listener.callback();
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Releasing references, shared by all pointer types
+
+    // Destroys the object with the last strong reference, the block once no references are left.
+    static void ReleaseStrong(BaseBlock* block) {
+        if (block->IsImmortal()) {
+            return;
+        }
+        if (block->GetStrongCounter() == 1) {
+            // Listeners may drop the last weak reference, keep the block until they are done
+            block->IncWeakCounter();
+            block->DecStrongCounter();
+            if (block->HasExpiryListeners()) {
+                block->NotifyExpired();
+            }
+            block->DecWeakCounter();
+        } else {
+            block->DecStrongCounter();
+        }
+        if (block->GetStrongCounter() == 0 && block->GetWeakCounter() == 0) {
+            delete block;
+        }
+    }
+    static void ReleaseWeak(BaseBlock* block) {
+        block->DecWeakCounter();
+        if (block->GetStrongCounter() == 0 && block->GetWeakCounter() == 0) {
+            delete block;
+        }
+    }
+
+private:
+    static constexpr size_t kHasListeners = size_t(1) << (sizeof(size_t) * 8 - 1);
+
+    struct ExpiryListener {
+        size_t id;
+        std::function<void()> callback;
+    };
+    using ListenerTable = std::unordered_map<const BaseBlock*, std::vector<ExpiryListener>>;
+    // Never destroyed: pointers in statics may release after static destruction reached it
+    static ListenerTable& ExpiryTable() {
+        static ListenerTable* table = new ListenerTable();
+        return *table;
     }
 };
 
+// Base of the generic control blocks for objects of type `T`
 template <typename T>
-class CBlockObj : public BaseBlock {
+using BlockFor = std::conditional_t<kStrongOnly<T>, StrongBlock, BaseBlock>;
+
+template <typename T>
+class CBlockObj : public BlockFor<T> {
 protected:
     std::aligned_storage_t<sizeof(T), alignof(T)> obj_;
     // alignas(T) char obj_[sizeof(T)];
@@ -52,8 +215,8 @@ public:
         ::new (reinterpret_cast<T*>(&obj_)) T(std::forward<Args>(args)...);
     }
     void DecStrongCounter() override {
-        strong_counter_ -= 1;
-        if (!strong_counter_) {
+        this->strong_counter_ -= 1;
+        if (!this->strong_counter_) {
             reinterpret_cast<T*>(&obj_)->~T();
         }
     }
@@ -68,7 +231,7 @@ public:
 };
 
 template <typename T>
-class CBlockPtr : public BaseBlock {
+class CBlockPtr : public BlockFor<T> {
 protected:
     T* obj_ptr_ = nullptr;
 
@@ -77,8 +240,8 @@ public:
         obj_ptr_ = ptr;
     }
     void DecStrongCounter() override {
-        strong_counter_ -= 1;
-        if (!strong_counter_) {
+        this->strong_counter_ -= 1;
+        if (!this->strong_counter_) {
             delete obj_ptr_;
             obj_ptr_ = nullptr;
         }
@@ -92,10 +255,109 @@ public:
     }
 };
 
+template <typename T, typename Deleter>
+class CBlockDeleter : public BlockFor<T> {
+protected:
+    T* obj_ptr_ = nullptr;
+    Deleter deleter_;
+
+public:
+    CBlockDeleter(T* ptr, Deleter deleter) : obj_ptr_(ptr), deleter_(std::move(deleter)) {
+    }
+    void DecStrongCounter() override {
+        this->strong_counter_ -= 1;
+        if (!this->strong_counter_) {
+            deleter_(obj_ptr_);
+            obj_ptr_ = nullptr;
+        }
+    }
+
+    ~CBlockDeleter() override {
+        if (obj_ptr_) {
+            deleter_(obj_ptr_);
+            obj_ptr_ = nullptr;
+        }
+    }
+};
+
+// Address of the object `CBlockHeader::Create` is constructing. `EnableSharedFromAddress` asserts
+// it is that object: anywhere else (stack, `new`, members) there is no block in front of it.
+inline const void*& AddressObjectUnderConstruction() {
+    static thread_local const void* object = nullptr;
+    return object;
+}
+
+// Control block right in front of the object in one allocation. Unlike `CBlockObj`
+// the offset is known, so the object can find its block from its own address.
+template <typename T>
+class CBlockHeader : public BaseBlock {
+public:
+    template <typename... Args>
+    static CBlockHeader* Create(Args&&... args) {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "T is over-aligned");
+        void* memory = ::operator new(ObjectOffset() + sizeof(T));
+        auto* block = ::new (memory) CBlockHeader();
+        AddressObjectUnderConstruction() = block->GetObject();
+        SMART_PTRS_TRY {
+            ::new (block->GetObject()) T(std::forward<Args>(args)...);
+        } SMART_PTRS_CATCH_ALL {
+            AddressObjectUnderConstruction() = nullptr;
+            block->~CBlockHeader();
+            ::operator delete(memory);
+            SMART_PTRS_RETHROW;
+        }
+        AddressObjectUnderConstruction() = nullptr;
+        return block;
+    }
+
+    // Matches the unsized allocation in `Create`
+    static void operator delete(void* ptr) {
+        ::operator delete(ptr);
+    }
+
+    void DecStrongCounter() override {
+        strong_counter_ -= 1;
+        if (!strong_counter_) {
+            GetObject()->~T();
+        }
+    }
+
+    T* GetObject() {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(this) + ObjectOffset());
+    }
+    static CBlockHeader* FromObject(const T* object) {
+        return reinterpret_cast<CBlockHeader*>(
+            const_cast<char*>(reinterpret_cast<const char*>(object)) - ObjectOffset());
+    }
+
+private:
+    CBlockHeader() = default;
+
+    static constexpr size_t ObjectOffset() {
+        return (sizeof(CBlockHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+};
+
+// Control block of an object that is never destroyed, e.g. one with static storage.
+class ImmortalBlock : public BaseBlock {
+public:
+    ImmortalBlock() {
+        strong_counter_ = kImmortal;
+    }
+    void DecStrongCounter() override {
+    }
+};
+
 class EnableSharedFromThisBase {};
+class EnableSharedFromBlockBase {};
+class EnableSharedFromAddressBase {};
 
 template <typename T>
 class EnableSharedFromThis;
+template <typename T>
+class EnableSharedFromBlock;
+template <typename T>
+class EnableSharedFromAddress;
 
 template <typename T>
 class SharedPtr {
@@ -105,12 +367,27 @@ class SharedPtr {
     template <typename Y, typename... Args>
     friend SharedPtr<Y> MakeShared(Args&&... args);
 
+    template <typename Y, typename Block>
+    friend SharedPtr<Y> SharedFromBlock(Block* block, Y* ptr);
+
     template <typename Y>
     friend class WeakPtr;
 
     template <typename y>
     friend class EnableSharedFromThis;
 
+    template <typename Y>
+    friend class EnableSharedFromBlock;
+
+    template <typename Y>
+    friend class EnableSharedFromAddress;
+
+    template <typename Y>
+    friend class ThinSharedPtr;
+
+    template <typename Y>
+    friend class StaticShared;
+
 public:
     ////////////////////////////////////////////////////////////////////////////////////////////////
     // Constructors
@@ -119,18 +396,33 @@ public:
     SharedPtr(std::nullptr_t) : observer_(nullptr), block_(nullptr) {
     }
     explicit SharedPtr(T* ptr) : observer_(ptr) {
+        static_assert(!std::is_convertible<T*, EnableSharedFromAddressBase*>::value,
+                      "EnableSharedFromAddress objects are created by MakeShared only");
         block_ = new CBlockPtr<T>(ptr);
-        if constexpr (std::is_convertible<T*, EnableSharedFromThisBase*>::value) {
-            InitWeakThis(ptr);
-        }
+        InitFromThis(ptr);
     }
 
     template <typename Y>
     explicit SharedPtr(Y* ptr) : observer_(ptr) {
+        static_assert(!std::is_convertible<Y*, EnableSharedFromAddressBase*>::value,
+                      "EnableSharedFromAddress objects are created by MakeShared only");
         block_ = new CBlockPtr<Y>(ptr);
-        if constexpr (std::is_convertible<T*, EnableSharedFromThisBase*>::value) {
-            InitWeakThis(ptr);
+        InitFromThis(ptr);
+    }
+
+    // #4 from https://en.cppreference.com/w/cpp/memory/shared_ptr/shared_ptr
+    template <typename Y, typename Deleter>
+    SharedPtr(Y* ptr, Deleter deleter) : observer_(ptr) {
+        static_assert(!std::is_convertible<Y*, EnableSharedFromAddressBase*>::value,
+                      "EnableSharedFromAddress objects are created by MakeShared only");
+        SMART_PTRS_TRY {
+            block_ = new CBlockDeleter<Y, Deleter>(ptr, deleter);
+        } SMART_PTRS_CATCH_ALL {
+            deleter(ptr);
+            SMART_PTRS_RETHROW;
         }
+        // The deleter may leave the object alive, it must not outlive the block then
+        InitFromThis(ptr, /*pin_block=*/true);
     }
 
     SharedPtr(const SharedPtr& other) {
@@ -140,6 +432,7 @@ public:
     }
     template <typename Y>
     SharedPtr(const SharedPtr<Y>& other) {
+        CheckSameBlock<Y>();
         DecBlock();
         observer_ = other.observer_;
         block_ = other.block_;
@@ -154,6 +447,7 @@ public:
     }
     template <typename Y>
     SharedPtr(SharedPtr<Y>&& other) {
+        CheckSameBlock<Y>();
         DecBlock();
         observer_ = other.observer_;
         block_ = other.block_;
@@ -165,22 +459,23 @@ public:
     // #8 from https://en.cppreference.com/w/cpp/memory/shared_ptr/shared_ptr
     template <typename Y>
     SharedPtr(const SharedPtr<Y>& other, T* ptr) {
+        CheckSameBlock<Y>();
         observer_ = ptr;
         block_ = other.block_;
         IncBlock();
     }
 
-    // Promote WeakPtr
+    // Promote WeakPtr. Throws BadWeakPtr if expired, see `WeakPtr::TryLock` for the non-throwing way
     // #11 from https://en.cppreference.com/w/cpp/memory/shared_ptr/shared_ptr
-    explicit SharedPtr(const WeakPtr<T>& other) {
-        if (other.block_ && other.block_->GetStrongCounter() == 0 &&
-            other.block_->GetWeakCounter() != 0) {
-            throw BadWeakPtr();
-        }
-        block_ = other.block_;
-        if (block_) {
+    // A template, so overload resolution never instantiates `WeakPtr` of strong-only types
+    template <typename Y>
+    explicit SharedPtr(const WeakPtr<Y>& other) {
+        if (other.block_) {
+            if (!other.block_->TryIncStrongCounter()) {
+                SMART_PTRS_THROW(BadWeakPtr());
+            }
+            block_ = other.block_;
             observer_ = other.observer_;
-            IncBlock();
         }
     }
 
@@ -199,6 +494,7 @@ public:
 
     template <typename Y>
     SharedPtr& operator=(const SharedPtr<Y>& other) {
+        CheckSameBlock<Y>();
         if (other.block_) {
             other.block_->IncStrongCounter();
         }
@@ -219,6 +515,7 @@ public:
 
     template <typename Y>
     SharedPtr& operator=(SharedPtr<Y>&& other) {
+        CheckSameBlock<Y>();
         DecBlock();
         block_ = std::move(other.block_);
         observer_ = std::move(other.observer_);
@@ -247,6 +544,7 @@ public:
     void Reset(Y* ptr) {
         DecBlock();
         observer_ = ptr;
+        block_ = nullptr;
         if (ptr) {
             block_ = new CBlockPtr<Y>(ptr);
         }
@@ -274,6 +572,16 @@ public:
         }
         return 0;
     }
+    // Weak references to the object, the one an `EnableSharedFromThis` object keeps to itself
+    // included. Always 0 for strong-only types.
+    size_t WeakCount() const {
+        if constexpr (!kStrongOnly<T>) {
+            if (block_) {
+                return block_->GetWeakCounter();
+            }
+        }
+        return 0;
+    }
     explicit operator bool() const {
         if (observer_) {
             return true;
@@ -281,26 +589,74 @@ public:
         return false;
     }
 
+    // Identity of the control block: equal for all owners of one object, aliases included.
+    const void* OwnerId() const {
+        return block_;
+    }
+
+    // Stops reference counting for the object: it and its block stay until the process exits.
+    // For process-lifetime singletons whose counters would be touched by every copy.
+    void MakeImmortal() const {
+        if (block_) {
+            block_->MakeImmortal();
+        }
+    }
+
+    // Calls `callback` once the last strong reference is gone, right after the object dies.
+    // Returns an id for `CancelOnExpired`, 0 for an empty pointer.
+    size_t OnExpired(std::function<void()> callback) const {
+        if (block_) {
+            return block_->AddExpiryListener(std::move(callback));
+        }
+        return 0;
+    }
+    void CancelOnExpired(size_t id) const {
+        if (block_) {
+            block_->RemoveExpiryListener(id);
+        }
+    }
+
     template <typename Y>
     void InitWeakThis(EnableSharedFromThis<Y>* e) {
         e->weak_this_ = *this;
     }
 
 private:
-    // поменять??
+    template <typename Y>
+    static void CheckSameBlock() {
+        static_assert(kStrongOnly<T> == kStrongOnly<Y>,
+                      "SharedPtr conversions between strong-only and regular types are not "
+                      "supported, see IsStrongOnly");
+    }
+
+    // Points the back-reference of a `SharedFromThis` mixin at this pointer's block
+    template <typename Y>
+    void InitFromThis(Y* ptr, bool pin_block = false) {
+        if constexpr (std::is_convertible<T*, EnableSharedFromThisBase*>::value) {
+            InitWeakThis(ptr);
+        }
+        if constexpr (std::is_convertible<T*, EnableSharedFromBlockBase*>::value) {
+            InitBlockThis(ptr, pin_block);
+        }
+    }
+    template <typename Y>
+    void InitBlockThis(EnableSharedFromBlock<Y>* e, bool pin_block) {
+        e->SetBlockThis(block_, pin_block);
+    }
+
+    // Shares `ptr` through `block` if the object is still alive, empty otherwise
+    static SharedPtr TryPromote(BlockFor<T>* block, T* ptr) {
+        SharedPtr result;
+        if (block && block->TryIncStrongCounter()) {
+            result.block_ = block;
+            result.observer_ = ptr;
+        }
+        return result;
+    }
+
     void DecBlock() {
         if (block_) {
-            if (block_->GetStrongCounter() == 1) {
-                block_->IncWeakCounter();
-                block_->DecStrongCounter();
-                block_->DecWeakCounter();
-            } else {
-                block_->DecStrongCounter();
-            }
-            if (block_ && UseCount() == 0 && block_->GetWeakCounter() == 0) {
-                delete block_;
-                block_ = nullptr;
-            }
+            BlockFor<T>::ReleaseStrong(block_);
         }
     }
     void IncBlock() {
@@ -308,10 +664,13 @@ private:
             block_->IncStrongCounter();
         }
     }
-    BaseBlock* block_ = nullptr;
+    BlockFor<T>* block_ = nullptr;
     T* observer_ = nullptr;
 };
 
+template <typename T>
+SharedPtr(const WeakPtr<T>&) -> SharedPtr<T>;
+
 template <typename T, typename Y>
 inline bool operator==(const SharedPtr<T>& left, const SharedPtr<Y>& right) {
     return (left.Get() == right.Get());
@@ -322,19 +681,68 @@ bool operator==(const SharedPtr<T>& left, std::nullptr_t) noexcept {
     return !left;
 }
 
-// Allocate memory only once
-template <typename T, typename... Args>
-SharedPtr<T> MakeShared(Args&&... args) {
-    SharedPtr<T> new_sptr;
-    CBlockObj<T>* b = new CBlockObj<T>(std::forward<Args>(args)...);
-    new_sptr.observer_ = b->GetObject();
-    new_sptr.block_ = b;
-    if constexpr (std::is_convertible<T*, EnableSharedFromThisBase*>::value) {
-        new_sptr.InitWeakThis(new_sptr.observer_);
+template <typename T>
+struct std::hash<SharedPtr<T>> {
+    size_t operator()(const SharedPtr<T>& ptr) const {
+        return std::hash<T*>()(ptr.Get());
     }
+};
+
+// Adopts the single strong reference of a freshly created block.
+// For control blocks with a custom layout, e.g. trailing storage.
+template <typename T, typename Block>
+SharedPtr<T> SharedFromBlock(Block* block, T* ptr) {
+    static_assert(!std::is_convertible<T*, EnableSharedFromAddressBase*>::value ||
+                      std::is_same<Block, CBlockHeader<T>>::value,
+                  "EnableSharedFromAddress objects are created by MakeShared only");
+    SharedPtr<T> new_sptr;
+    new_sptr.observer_ = ptr;
+    new_sptr.block_ = block;
+    new_sptr.InitFromThis(ptr);
     return new_sptr;
 }
 
+// Where `MakeSharedWithLayout` puts the object.
+// kInline: inside the control block, one allocation, but the memory stays until the last `WeakPtr`.
+// kSplit: a separate allocation, freed as soon as the strong count hits zero.
+// kAuto: kSplit for objects of at least `kSplitLayoutThreshold` bytes, kInline otherwise.
+// `EnableSharedFromAddress` types always go right behind their block.
+enum class SharedLayout { kAuto, kInline, kSplit };
+
+inline constexpr size_t kSplitLayoutThreshold = 4096;
+
+template <typename T, SharedLayout Layout = SharedLayout::kAuto, typename... Args>
+SharedPtr<T> MakeSharedWithLayout(Args&&... args) {
+    constexpr bool kSplit = Layout == SharedLayout::kSplit ||
+                            (Layout == SharedLayout::kAuto && sizeof(T) >= kSplitLayoutThreshold);
+    if constexpr (std::is_convertible<T*, EnableSharedFromAddressBase*>::value) {
+        static_assert(std::is_base_of<EnableSharedFromAddress<T>, T>::value,
+                      "T has to derive from EnableSharedFromAddress<T> itself");
+        static_assert(Layout != SharedLayout::kSplit, "The object has to follow its block");
+        CBlockHeader<T>* block = CBlockHeader<T>::Create(std::forward<Args>(args)...);
+        return SharedFromBlock(block, block->GetObject());
+    } else if constexpr (kSplit) {
+        T* object = new T(std::forward<Args>(args)...);
+        CBlockPtr<T>* block;
+        SMART_PTRS_TRY {
+            block = new CBlockPtr<T>(object);
+        } SMART_PTRS_CATCH_ALL {
+            delete object;
+            SMART_PTRS_RETHROW;
+        }
+        return SharedFromBlock(block, object);
+    } else {
+        CBlockObj<T>* block = new CBlockObj<T>(std::forward<Args>(args)...);
+        return SharedFromBlock(block, block->GetObject());
+    }
+}
+
+// Allocate memory only once, unless the object is big enough for the split layout
+template <typename T, typename... Args>
+SharedPtr<T> MakeShared(Args&&... args) {
+    return MakeSharedWithLayout<T, SharedLayout::kAuto>(std::forward<Args>(args)...);
+}
+
 // Look for usage examples in tests
 
 template <typename T>
@@ -362,6 +770,14 @@ public:
         return SharedPtr<T>(weak_this_);
     }
 
+    // Empty instead of throwing if the object is not owned by a SharedPtr (anymore).
+    SharedPtr<const T> TrySharedFromThis() const {
+        return weak_this_.TryLock();
+    }
+    SharedPtr<T> TrySharedFromThis() {
+        return weak_this_.TryLock();
+    }
+
     WeakPtr<T> WeakFromThis() noexcept {
         return weak_this_;
     }
@@ -371,4 +787,153 @@ public:
 
 private:
     WeakPtr<T> weak_this_;
-};
\ No newline at end of file
+};
+
+// `EnableSharedFromThis` without the `WeakPtr`: keeps only the control block, one word.
+// Owners made by `MakeShared` or `SharedPtr(T*)` destroy the object before its block, so the
+// mixin does not count as a reference. Only with a custom deleter, which may leave the object
+// alive (stack objects, objects owned elsewhere), does it hold a weak reference to the block.
+template <typename T>
+class EnableSharedFromBlock : public EnableSharedFromBlockBase {
+    template <typename Y>
+    friend class SharedPtr;
+
+public:
+    EnableSharedFromBlock() noexcept = default;
+    // A copy is a different object with an owner of its own
+    EnableSharedFromBlock(const EnableSharedFromBlock&) noexcept {
+    }
+    EnableSharedFromBlock& operator=(const EnableSharedFromBlock&) noexcept {
+        return *this;
+    }
+    ~EnableSharedFromBlock() {
+        ReleaseBlockThis();
+    }
+
+    // Empty if the object is not owned by a SharedPtr, throws BadWeakPtr while it is destroyed.
+    SharedPtr<const T> SharedFromThis() const {
+        auto result = TrySharedFromThis();
+        if (!result && block_this_.Get()) {
+            SMART_PTRS_THROW(BadWeakPtr());
+        }
+        return result;
+    }
+    SharedPtr<T> SharedFromThis() {
+        auto result = TrySharedFromThis();
+        if (!result && block_this_.Get()) {
+            SMART_PTRS_THROW(BadWeakPtr());
+        }
+        return result;
+    }
+
+    SharedPtr<const T> TrySharedFromThis() const {
+        return SharedPtr<const T>::TryPromote(block_this_.Get(), static_cast<const T*>(this));
+    }
+    SharedPtr<T> TrySharedFromThis() {
+        return SharedPtr<T>::TryPromote(block_this_.Get(), static_cast<T*>(this));
+    }
+
+private:
+    void SetBlockThis(BaseBlock* block, bool pin_block) {
+        if (pin_block) {
+            block->IncWeakCounter();
+        }
+        ReleaseBlockThis();
+        block_this_ = TaggedPointer<BaseBlock, 1>(block, pin_block);
+    }
+    void ReleaseBlockThis() {
+        if (block_this_.GetTag()) {
+            BaseBlock::ReleaseWeak(block_this_.Get());
+        }
+    }
+
+    // Tagged when the mixin holds a weak reference to the block
+    TaggedPointer<BaseBlock, 1> block_this_;
+};
+
+// Stores nothing at all: `MakeShared` puts the object right behind its control block
+// and `SharedFromThis` finds the block from `this`. Such objects must be created by `MakeShared`,
+// on the stack or inside another object there is no block to find.
+// `T` has to be the type passed to `MakeShared`.
+template <typename T>
+class EnableSharedFromAddress : public EnableSharedFromAddressBase {
+public:
+    EnableSharedFromAddress() noexcept {
+        CheckConstructedByMakeShared();
+    }
+    EnableSharedFromAddress(const EnableSharedFromAddress&) noexcept {
+        CheckConstructedByMakeShared();
+    }
+    EnableSharedFromAddress& operator=(const EnableSharedFromAddress&) noexcept {
+        return *this;
+    }
+
+    // Throws BadWeakPtr while the object is destroyed.
+    SharedPtr<const T> SharedFromThis() const {
+        auto result = TrySharedFromThis();
+        if (!result) {
+            SMART_PTRS_THROW(BadWeakPtr());
+        }
+        return result;
+    }
+    SharedPtr<T> SharedFromThis() {
+        auto result = TrySharedFromThis();
+        if (!result) {
+            SMART_PTRS_THROW(BadWeakPtr());
+        }
+        return result;
+    }
+
+    SharedPtr<const T> TrySharedFromThis() const {
+        auto* object = static_cast<const T*>(this);
+        return SharedPtr<const T>::TryPromote(CBlockHeader<T>::FromObject(object), object);
+    }
+    SharedPtr<T> TrySharedFromThis() {
+        auto* object = static_cast<T*>(this);
+        return SharedPtr<T>::TryPromote(CBlockHeader<T>::FromObject(object), object);
+    }
+
+private:
+    void CheckConstructedByMakeShared() {
+        assert(AddressObjectUnderConstruction() == static_cast<T*>(this) &&
+               "EnableSharedFromAddress objects are created by MakeShared only");
+        AddressObjectUnderConstruction() = nullptr;
+    }
+};
+
+// `T` with static storage handed out as SharedPtr, without a heap block. Immortal: counting is
+// skipped and neither the object nor its block are destroyed, not even at exit, so pointers held
+// by other statics stay valid during static destruction.
+//
+//     static StaticShared<const std::string> kEmpty;
+//     SharedPtr<const std::string> empty = kEmpty.Share();
+template <typename T>
+class StaticShared {
+public:
+    template <typename... Args>
+    explicit StaticShared(Args&&... args) {
+        static_assert(!std::is_convertible<T*, EnableSharedFromAddressBase*>::value,
+                      "EnableSharedFromAddress objects are created by MakeShared only");
+        ::new (&storage_) Payload{ImmortalBlock(), T(std::forward<Args>(args)...)};
+        // Hand out the first reference as well, so the mixins get initialized
+        SharedFromBlock(&Get().block, &Get().object);
+    }
+    StaticShared(const StaticShared&) = delete;
+    StaticShared& operator=(const StaticShared&) = delete;
+
+    SharedPtr<T> Share() {
+        return SharedPtr<T>::TryPromote(&Get().block, &Get().object);
+    }
+
+private:
+    struct Payload {
+        ImmortalBlock block;
+        T object;
+    };
+
+    Payload& Get() {
+        return *reinterpret_cast<Payload*>(&storage_);
+    }
+
+    std::aligned_storage_t<sizeof(Payload), alignof(Payload)> storage_;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <common/exceptions.h>
+
 #include <exception>
 
 class BadWeakPtr : public std::exception {};
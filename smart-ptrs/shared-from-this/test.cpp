@@ -89,3 +89,98 @@ TEST_CASE("WeakFromThis") {
     REQUIRE(!weak.Expired());
     REQUIRE(weak.Lock().Get() == ptr);
 }
+
+struct SelfInDestructor : public EnableSharedFromThis<SelfInDestructor> {
+    ~SelfInDestructor() {
+        promoted = !!TrySharedFromThis();
+    }
+    inline static bool promoted = true;
+};
+
+TEST_CASE("TrySharedFromThis") {
+    SECTION("Unowned") {
+        T t;
+        REQUIRE(!t.TrySharedFromThis());
+        REQUIRE(!static_cast<const T&>(t).TrySharedFromThis());
+    }
+
+    SECTION("Owned") {
+        auto p = MakeShared<T>();
+        REQUIRE(p->TrySharedFromThis() == p);
+        REQUIRE(p.UseCount() == 1);
+    }
+
+    SECTION("In destructor") {
+        MakeShared<SelfInDestructor>();
+        REQUIRE(!SelfInDestructor::promoted);
+    }
+}
+
+struct Lean : EnableSharedFromBlock<Lean> {
+    ~Lean() {
+        promoted = !!TrySharedFromThis();
+    }
+    inline static bool promoted = true;
+};
+
+struct Bare : EnableSharedFromAddress<Bare> {
+    ~Bare() {
+        promoted = !!TrySharedFromThis();
+    }
+    int value = 7;
+    inline static bool promoted = true;
+};
+
+TEST_CASE("Lightweight SharedFromThis") {
+    static_assert(sizeof(Lean) == sizeof(void*));
+    static_assert(sizeof(Bare) == sizeof(int));
+
+    SECTION("Block") {
+        Lean unowned;
+        REQUIRE(!unowned.SharedFromThis());
+
+        auto check = [](SharedPtr<Lean> p) {
+            auto q = p->SharedFromThis();
+            REQUIRE(q == p);
+            REQUIRE(p.UseCount() == 2);
+            REQUIRE(p.WeakCount() == 0);
+            const Lean& ref = *p;
+            REQUIRE(ref.SharedFromThis() == p);
+        };
+        check(MakeShared<Lean>());
+        REQUIRE(!Lean::promoted);
+        Lean::promoted = true;
+        check(SharedPtr<Lean>(new Lean));
+        REQUIRE(!Lean::promoted);
+
+        Lean copy = *MakeShared<Lean>();
+        REQUIRE(!copy.TrySharedFromThis());
+    }
+
+    SECTION("Block outlives a non-owning deleter") {
+        Lean::promoted = true;
+        {
+            Lean on_stack;
+            {
+                SharedPtr<Lean> p(&on_stack, [](Lean*) {});
+                REQUIRE(on_stack.SharedFromThis() == p);
+                REQUIRE(p.WeakCount() == 1);
+            }
+            REQUIRE(!on_stack.TrySharedFromThis());
+        }
+        REQUIRE(!Lean::promoted);
+    }
+
+    SECTION("Address") {
+        auto p = MakeShared<Bare>();
+        REQUIRE(p->value == 7);
+        auto q = p->SharedFromThis();
+        REQUIRE(q.Get() == p.Get());
+        REQUIRE(p.UseCount() == 2);
+        WeakPtr<Bare> weak = q;
+        q.Reset();
+        p.Reset();
+        REQUIRE(!Bare::promoted);
+        REQUIRE(weak.Expired());
+    }
+}
@@ -0,0 +1,93 @@
+#include "buffer.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <string>
+
+TEST_CASE("Shared buffer") {
+    SECTION("One allocation") {
+        EXPECT_ONE_ALLOCATION(SharedBuffer buffer(100));
+        EXPECT_ZERO_ALLOCATIONS(SharedBuffer empty);
+    }
+
+    SECTION("Slice") {
+        auto buffer = SharedBuffer::Copy("GET /index.html");
+        SharedBuffer method;
+        EXPECT_ZERO_ALLOCATIONS(method = buffer.Slice(0, 3));
+        REQUIRE(method.View() == "GET");
+        REQUIRE(method.Data() == buffer.Data());
+        REQUIRE(buffer.UseCount() == 2);
+        REQUIRE(buffer.Slice(4).View() == "/index.html");
+        REQUIRE(buffer.Slice(100).Empty());
+    }
+
+    SECTION("Split") {
+        auto buffer = SharedBuffer::Copy("headerbody");
+        auto header = buffer.Split(6);
+        REQUIRE(header.View() == "header");
+        REQUIRE(buffer.View() == "body");
+        REQUIRE(header.Data() + 6 == buffer.Data());
+    }
+
+    SECTION("Copy on write") {
+        auto buffer = SharedBuffer::Copy("abc");
+        const std::byte* original = buffer.Data();
+        buffer.MutableData()[0] = std::byte('x');
+        REQUIRE(buffer.Data() == original);
+        REQUIRE(buffer.View() == "xbc");
+
+        auto copy = buffer;
+        copy.MutableData()[1] = std::byte('y');
+        REQUIRE(copy.Data() != original);
+        REQUIRE(copy.View() == "xyc");
+        REQUIRE(buffer.View() == "xbc");
+        REQUIRE(buffer.UseCount() == 1);
+    }
+
+    SECTION("Outlives the original") {
+        SharedBuffer tail;
+        {
+            auto buffer = SharedBuffer::Copy("keep the tail");
+            tail = buffer.Slice(9);
+        }
+        REQUIRE(tail.View() == "tail");
+
+        auto moved = std::move(tail);
+        REQUIRE(moved.View() == "tail");
+        REQUIRE(tail.Empty());
+    }
+}
+
+TEST_CASE("Buffer chain") {
+    BufferChain chain;
+    chain.Append(SharedBuffer::Copy("hel"));
+    chain.Append(SharedBuffer::Copy("lo wo"));
+    chain.Append(SharedBuffer());
+    chain.Append(SharedBuffer::Copy("rld"));
+    REQUIRE(chain.Size() == 11);
+    REQUIRE(chain.NumSegments() == 3);
+
+    SECTION("Split") {
+        auto hello = chain.Split(5);
+        REQUIRE(hello.Size() == 5);
+        REQUIRE(hello.NumSegments() == 2);
+        REQUIRE(hello.Coalesce().View() == "hello");
+        REQUIRE(chain.Size() == 6);
+        REQUIRE(chain.Coalesce().View() == " world");
+    }
+
+    SECTION("Append chain") {
+        BufferChain other;
+        other.Append(SharedBuffer::Copy("!"));
+        chain.Append(std::move(other));
+        REQUIRE(other.Empty());
+        REQUIRE(chain.Coalesce().View() == "hello world!");
+    }
+
+    SECTION("Single segment coalesces without copying") {
+        auto front = chain.Split(3);
+        REQUIRE(front.Coalesce().Data() == front.Segments().front().Data());
+    }
+}
@@ -0,0 +1,122 @@
+#include "cache.h"
+
+#include <catch.hpp>
+
+#include <deque>
+#include <string>
+
+TEST_CASE("Shared cache") {
+    int loads = 0;
+    auto loader = [&loads](int key) {
+        return [&loads, key] {
+            ++loads;
+            return MakeShared<std::string>(std::to_string(key));
+        };
+    };
+
+    SECTION("Hits") {
+        SharedCache<int, std::string> cache(2);
+        REQUIRE(*cache.GetOrLoad(1, loader(1)) == "1");
+        REQUIRE(*cache.GetOrLoad(1, loader(1)) == "1");
+        REQUIRE(loads == 1);
+        REQUIRE(cache.GetStats().hits == 1);
+        REQUIRE(cache.GetStats().misses == 1);
+    }
+
+    SECTION("LRU eviction") {
+        SharedCache<int, std::string> cache(2);
+        cache.GetOrLoad(1, loader(1));
+        cache.GetOrLoad(2, loader(2));
+        cache.Get(1);
+        cache.GetOrLoad(3, loader(3));
+        REQUIRE(cache.NumStrong() == 2);
+        REQUIRE(cache.Size() == 2);
+        REQUIRE(cache.Get(1));
+        REQUIRE(!cache.Get(2));
+        REQUIRE(cache.Get(3));
+    }
+
+    SECTION("Evicted values in use are not reloaded") {
+        SharedCache<int, std::string> cache(1);
+        auto in_use = cache.GetOrLoad(1, loader(1));
+        cache.GetOrLoad(2, loader(2));
+        REQUIRE(cache.NumStrong() == 1);
+        REQUIRE(cache.Size() == 2);
+
+        auto again = cache.GetOrLoad(1, loader(1));
+        REQUIRE(again.Get() == in_use.Get());
+        REQUIRE(loads == 2);
+        REQUIRE(cache.GetStats().weak_hits == 1);
+
+        in_use.Reset();
+        again.Reset();
+        cache.GetOrLoad(3, loader(3));
+        cache.Sweep();
+        REQUIRE(cache.Size() == 1);
+    }
+
+    SECTION("Byte budget") {
+        SharedCache<int, std::string> cache(100, 10);
+        cache.Put(1, MakeShared<std::string>("a"), 4);
+        cache.Put(2, MakeShared<std::string>("b"), 4);
+        REQUIRE(cache.Bytes() == 8);
+        cache.Put(3, MakeShared<std::string>("c"), 4);
+        REQUIRE(cache.Bytes() == 8);
+        REQUIRE(!cache.Get(1));
+
+        cache.Put(4, MakeShared<std::string>("huge"), 100);
+        REQUIRE(cache.NumStrong() == 1);
+        REQUIRE(*cache.Get(4) == "huge");
+    }
+
+    SECTION("Replace and erase") {
+        SharedCache<int, std::string> cache(2);
+        cache.Put(1, MakeShared<std::string>("old"));
+        cache.Put(1, MakeShared<std::string>("new"));
+        REQUIRE(cache.NumStrong() == 1);
+        REQUIRE(*cache.Get(1) == "new");
+        cache.Erase(1);
+        REQUIRE(cache.Size() == 0);
+        REQUIRE(!cache.Get(1));
+    }
+
+    SECTION("Expired entries are forgotten under churn") {
+        SharedCache<int, std::string> cache(4);
+        std::deque<SharedPtr<std::string>> users;  // keep evicted values alive for a while
+        for (int i = 0; i < 1000; ++i) {
+            users.push_back(cache.GetOrLoad(i, loader(i)));
+            if (users.size() > 16) {
+                users.pop_front();
+            }
+            REQUIRE(cache.Size() <= 4 + 16 + 16);
+        }
+        users.clear();
+        cache.Sweep();
+        REQUIRE(cache.Size() == 4);
+    }
+
+    SECTION("Not found is not cached") {
+        SharedCache<int, std::string> cache(1);
+        auto not_found = [&loads] {
+            ++loads;
+            return SharedPtr<std::string>();
+        };
+        REQUIRE(!cache.GetOrLoad(1, not_found));
+        REQUIRE(!cache.GetOrLoad(1, not_found));
+        REQUIRE(loads == 2);
+        REQUIRE(cache.Size() == 0);
+        REQUIRE(cache.NumStrong() == 0);
+
+        cache.Put(2, SharedPtr<std::string>());
+        REQUIRE(cache.Size() == 0);
+        cache.GetOrLoad(3, loader(3));
+        cache.GetOrLoad(4, loader(4));
+        cache.GetOrLoad(5, loader(5));
+        REQUIRE(cache.NumStrong() == 1);
+        REQUIRE(*cache.Get(5) == "5");
+
+        cache.Put(5, SharedPtr<std::string>());
+        REQUIRE(!cache.Get(5));
+        REQUIRE(cache.NumStrong() == 0);
+    }
+}
@@ -0,0 +1,83 @@
+#include "cow.h"
+#include "weak.h"
+
+#include <catch.hpp>
+
+#include <map>
+#include <string>
+
+struct Config {
+    static inline int copies = 0;
+
+    Config() = default;
+    Config(const Config& other) : values(other.values) {
+        ++copies;
+    }
+
+    std::map<std::string, int> values;
+};
+
+TEST_CASE("Copy on write") {
+    Config::copies = 0;
+
+    SECTION("Copies share") {
+        auto a = MakeCow<Config>();
+        a.Write().values["threads"] = 4;
+        auto b = a;
+        auto c = b;
+        REQUIRE(a.Get() == c.Get());
+        REQUIRE(a.UseCount() == 3);
+        REQUIRE(c->values.at("threads") == 4);
+        REQUIRE(Config::copies == 0);
+    }
+
+    SECTION("Write clones only when shared") {
+        auto a = MakeCow<Config>();
+        const Config* original = a.Get();
+        a.Write().values["x"] = 1;
+        REQUIRE(a.Get() == original);
+
+        auto b = a;
+        b.Write().values["x"] = 2;
+        REQUIRE(Config::copies == 1);
+        REQUIRE(b.Get() != original);
+        REQUIRE(a.Get() == original);
+        REQUIRE(a->values.at("x") == 1);
+        REQUIRE(b->values.at("x") == 2);
+
+        a.Write().values["x"] = 3;
+        REQUIRE(Config::copies == 1);
+        REQUIRE(a.Get() == original);
+    }
+
+    SECTION("Shared views pin the value") {
+        auto a = MakeCow<Config>();
+        auto view = a.Share();
+        a.Write().values["x"] = 1;
+        REQUIRE(Config::copies == 1);
+        REQUIRE(view->values.empty());
+    }
+
+    SECTION("Weak references to views pin the value") {
+        auto a = MakeCow<Config>();
+        WeakPtr<const Config> weak;
+        {
+            auto view = a.Share();
+            weak = view;
+        }
+        REQUIRE(a.UseCount() == 1);
+        REQUIRE(a.IsShared());
+        a.Write().values["x"] = 1;
+        REQUIRE(Config::copies == 1);
+        REQUIRE(weak.Expired());
+
+        a.Write().values["x"] = 2;
+        REQUIRE(Config::copies == 1);
+    }
+
+    SECTION("Empty") {
+        CowPtr<Config> empty;
+        REQUIRE(!empty);
+        REQUIRE(empty.UseCount() == 0);
+    }
+}
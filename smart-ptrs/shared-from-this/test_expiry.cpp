@@ -0,0 +1,67 @@
+#include "shared.h"
+#include "weak.h"
+
+#include <common/my_int.h>
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("Expiry listeners") {
+    SECTION("Fires on last strong reference") {
+        std::vector<std::string> events;
+        WeakPtr<MyInt> weak;
+        {
+            auto a = MakeShared<MyInt>(1);
+            weak = a;
+            REQUIRE(a.OnExpired([&] {
+                REQUIRE(MyInt::AliveCount() == 0);
+                REQUIRE(weak.Expired());
+                events.push_back("first");
+            }));
+            weak.OnExpired([&] { events.push_back("second"); });
+            SharedPtr<MyInt> b = a;
+            a.Reset();
+            REQUIRE(events.empty());
+        }
+        REQUIRE(events == std::vector<std::string>{"first", "second"});
+        REQUIRE(weak.OnExpired([] {}) == 0);
+    }
+
+    SECTION("Block without weak references") {
+        int fired = 0;
+        {
+            SharedPtr<std::string> p(new std::string("x"));
+            p.OnExpired([&] { ++fired; });
+        }
+        REQUIRE(fired == 1);
+    }
+
+    SECTION("Cancel") {
+        int fired = 0;
+        {
+            auto p = MakeShared<int>(5);
+            size_t id = p.OnExpired([&] { ++fired; });
+            p.OnExpired([&] { fired += 10; });
+            p.CancelOnExpired(id);
+        }
+        REQUIRE(fired == 10);
+    }
+
+    SECTION("Weak counter is unaffected") {
+        auto p = MakeShared<int>(5);
+        WeakPtr<int> w(p);
+        size_t id = p.OnExpired([] {});
+        REQUIRE(w.UseCount() == 1);
+        WeakPtr<int> w2(w);
+        w2.Reset();
+        p.CancelOnExpired(id);
+        REQUIRE(!w.Expired());
+    }
+
+    SECTION("Empty pointer") {
+        SharedPtr<int> empty;
+        REQUIRE(empty.OnExpired([] {}) == 0);
+    }
+}
@@ -0,0 +1,56 @@
+#include "shared.h"
+#include "weak.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <string>
+
+struct Sentinel : EnableSharedFromThis<Sentinel> {
+    ~Sentinel() {
+        destroyed = true;
+    }
+    inline static bool destroyed = false;
+};
+
+TEST_CASE("Immortal objects") {
+    SECTION("Pinned heap object") {
+        auto p = MakeShared<Sentinel>();
+        WeakPtr<Sentinel> weak = p;
+        // Intentionally never freed, keep it reachable for leak checkers
+        static Sentinel* pinned = p.Get();
+        REQUIRE(pinned);
+        p.MakeImmortal();
+        {
+            SharedPtr<Sentinel> q = p;
+            REQUIRE(q.UseCount() == StrongBlock::kImmortal);
+        }
+        p.Reset();
+        REQUIRE(!Sentinel::destroyed);
+        REQUIRE(!weak.Expired());
+        REQUIRE(weak.Lock()->SharedFromThis());
+    }
+
+    SECTION("Static storage") {
+        static StaticShared<const std::string> empty;
+        static StaticShared<std::string> greeting("hello");
+
+        SharedPtr<const std::string> a;
+        EXPECT_ZERO_ALLOCATIONS(a = empty.Share());
+        REQUIRE(a->empty());
+        REQUIRE(a == empty.Share());
+        REQUIRE(a.OwnerId() != greeting.Share().OwnerId());
+
+        WeakPtr<std::string> weak = greeting.Share();
+        REQUIRE(*weak.Lock() == "hello");
+        weak.Reset();
+        REQUIRE(*greeting.Share() == "hello");
+    }
+
+    SECTION("Static storage with SharedFromThis") {
+        static StaticShared<Sentinel> sentinel;
+        auto p = sentinel.Share();
+        REQUIRE(p->SharedFromThis() == p);
+    }
+}
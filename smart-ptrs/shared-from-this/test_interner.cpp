@@ -0,0 +1,73 @@
+#include "interner.h"
+
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("Interner") {
+    Interner<std::string> strings;
+
+    SECTION("Deduplicates live values") {
+        auto a = strings.Intern("tag:prod");
+        auto b = strings.Intern(std::string("tag:prod"));
+        auto c = strings.Intern("tag:dev");
+        REQUIRE(a.Get() == b.Get());
+        REQUIRE(a.Get() != c.Get());
+        REQUIRE(a.UseCount() == 2);
+        REQUIRE(strings.Size() == 2);
+        REQUIRE(strings.Find("tag:dev").Get() == c.Get());
+        REQUIRE(!strings.Find("tag:qa"));
+    }
+
+    SECTION("Values die with their last user") {
+        {
+            auto a = strings.Intern("short lived");
+            REQUIRE(strings.Find("short lived").Get() == a.Get());
+        }
+        REQUIRE(!strings.Find("short lived"));
+        auto b = strings.Intern("short lived");
+        REQUIRE(*b == "short lived");
+        REQUIRE(b.UseCount() == 1);
+    }
+
+    SECTION("Sweep") {
+        std::vector<SharedPtr<const std::string>> keep;
+        for (int i = 0; i < 1000; ++i) {
+            auto s = strings.Intern(std::to_string(i));
+            if (i % 10 == 0) {
+                keep.push_back(s);
+            }
+        }
+        REQUIRE(strings.Size() < 1000);
+        strings.Sweep();
+        REQUIRE(strings.Size() == keep.size());
+        for (const auto& s : keep) {
+            REQUIRE(strings.Intern(*s).Get() == s.Get());
+        }
+    }
+
+    SECTION("Expired entries do not grow the table") {
+        // 28 live values leave room for a few expired ones before the load factor limit of 2
+        std::vector<SharedPtr<const std::string>> keep;
+        for (int i = 0; i < 28; ++i) {
+            keep.push_back(strings.Intern(std::to_string(i)));
+        }
+        for (int i = 100; i < 1000; ++i) {
+            strings.Intern(std::to_string(i));
+        }
+        REQUIRE(strings.BucketCount() == 16);
+    }
+
+    SECTION("Churn at the limit") {
+        std::vector<SharedPtr<const std::string>> keep;
+        for (int i = 0; i < 31; ++i) {
+            keep.push_back(strings.Intern(std::to_string(i)));
+        }
+        for (int i = 100; i < 10000; ++i) {
+            strings.Intern(std::to_string(i));
+            REQUIRE(strings.Size() <= 3 * strings.BucketCount());
+        }
+        REQUIRE(strings.BucketCount() == 16);
+    }
+}
@@ -0,0 +1,60 @@
+#include "shared.h"
+#include "weak.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <new>
+
+template <size_t kSize>
+struct Blob {
+    static inline int allocated = 0;
+
+    static void* operator new(size_t size) {
+        ++allocated;
+        return ::operator new(size);
+    }
+    static void operator delete(void* ptr) {
+        --allocated;
+        ::operator delete(ptr);
+    }
+
+    char data[kSize];
+};
+
+TEST_CASE("Shared layout") {
+    SECTION("Small objects stay inline") {
+        using Small = Blob<64>;
+        EXPECT_ONE_ALLOCATION(auto p = MakeShared<Small>());
+        REQUIRE(Small::allocated == 0);
+    }
+
+    SECTION("Large objects are split") {
+        using Large = Blob<kSplitLayoutThreshold>;
+        WeakPtr<Large> weak;
+        {
+            auto p = MakeShared<Large>();
+            REQUIRE(Large::allocated == 1);
+            weak = p;
+        }
+        REQUIRE(weak.Expired());
+        REQUIRE(Large::allocated == 0);
+    }
+
+    SECTION("Explicit policy") {
+        using Small = Blob<16>;
+        WeakPtr<Small> weak;
+        {
+            auto p = MakeSharedWithLayout<Small, SharedLayout::kSplit>();
+            REQUIRE(Small::allocated == 1);
+            weak = p;
+            REQUIRE(p.UseCount() == 1);
+        }
+        REQUIRE(Small::allocated == 0);
+
+        using Large = Blob<2 * kSplitLayoutThreshold>;
+        EXPECT_ONE_ALLOCATION(auto p = MakeSharedWithLayout<Large, SharedLayout::kInline>());
+        REQUIRE(Large::allocated == 0);
+    }
+}
@@ -0,0 +1,100 @@
+#include "mapped_file.h"
+
+#include <catch.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+class TempFile {
+public:
+    explicit TempFile(const std::string& content) {
+        int fd = mkstemp(path_);
+        REQUIRE(fd >= 0);
+        REQUIRE(write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+        close(fd);
+    }
+    ~TempFile() {
+        unlink(path_);
+    }
+    std::string Path() const {
+        return path_;
+    }
+
+private:
+    char path_[32] = "/tmp/mapped_file_XXXXXX";
+};
+
+std::string ToString(const MappedFile& file) {
+    return std::string(reinterpret_cast<const char*>(file.Data()), file.Size());
+}
+
+TEST_CASE("Mapped file") {
+    TempFile tmp("header:payload:trailer");
+
+    SECTION("Contents") {
+        auto file = MappedFile::Open(tmp.Path());
+        REQUIRE(file.Size() == 22);
+        REQUIRE(ToString(file) == "header:payload:trailer");
+        REQUIRE(file.Span().size() == 22);
+        REQUIRE(file.Advise(MappedFile::Access::kSequential));
+    }
+
+    SECTION("Slices share the mapping") {
+        MappedFile payload;
+        {
+            auto file = MappedFile::Open(tmp.Path());
+            payload = file.Slice(7, 7);
+            REQUIRE(payload.Data() == file.Data() + 7);
+            REQUIRE(file.UseCount() == 2);
+        }
+        REQUIRE(payload.UseCount() == 1);
+        REQUIRE(ToString(payload) == "payload");
+        REQUIRE(payload.Advise(MappedFile::Access::kWillNeed));
+
+        auto tail = payload.Slice(4);
+        REQUIRE(ToString(tail) == "oad");
+        REQUIRE(payload.Slice(100).Size() == 0);
+    }
+
+    SECTION("Plain shared owner") {
+        SharedPtr<const std::byte> owner;
+        {
+            auto file = MappedFile::Open(tmp.Path());
+            owner = file.Slice(15).Owner();
+        }
+        REQUIRE(static_cast<char>(*owner) == 't');
+    }
+
+    SECTION("Empty file") {
+        TempFile empty("");
+        auto file = MappedFile::Open(empty.Path());
+        REQUIRE(file.Size() == 0);
+        REQUIRE(file.Data() == nullptr);
+    }
+
+    SECTION("Missing file") {
+        REQUIRE_THROWS_AS(MappedFile::Open("/nonexistent/file"), std::system_error);
+
+        std::error_code error;
+        auto file = MappedFile::Open("/nonexistent/file", error);
+        REQUIRE(error == std::errc::no_such_file_or_directory);
+        REQUIRE(file.Size() == 0);
+    }
+}
+
+TEST_CASE("Custom deleter") {
+    int deleted = 0;
+    {
+        SharedPtr<int> p(new int(5), [&deleted](int* ptr) {
+            ++deleted;
+            delete ptr;
+        });
+        SharedPtr<int> q = p;
+        REQUIRE(*q == 5);
+        p.Reset();
+        REQUIRE(deleted == 0);
+    }
+    REQUIRE(deleted == 1);
+}
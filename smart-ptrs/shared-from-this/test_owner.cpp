@@ -0,0 +1,60 @@
+#include "owner.h"
+
+#include <catch.hpp>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+struct Pair {
+    int first;
+    int second;
+};
+
+TEST_CASE("Owner based keys") {
+    SECTION("Aliases share the owner") {
+        auto pair = MakeShared<Pair>(Pair{1, 2});
+        SharedPtr<int> second(pair, &pair->second);
+        WeakPtr<Pair> weak(pair);
+        REQUIRE(OwnerEqual()(pair, second));
+        REQUIRE(OwnerEqual()(weak, second));
+        REQUIRE(OwnerHash()(pair) == OwnerHash()(second));
+        REQUIRE(!(pair == SharedPtr<Pair>(second, nullptr)));
+    }
+
+    SECTION("Expired weak keys stay findable") {
+        std::unordered_map<WeakPtr<std::string>, int, OwnerHash, OwnerEqual> seen;
+        WeakPtr<std::string> weak;
+        {
+            auto s = MakeShared<std::string>("gone soon");
+            weak = s;
+            seen[weak] = 42;
+            REQUIRE(seen.find(s) != seen.end());
+        }
+        REQUIRE(weak.Expired());
+        auto other = MakeShared<std::string>("new object");
+        REQUIRE(seen.find(weak)->second == 42);
+        REQUIRE(seen.find(other) == seen.end());
+    }
+
+    SECTION("Ordering") {
+        auto a = MakeShared<int>(1);
+        auto b = MakeShared<int>(2);
+        std::map<WeakPtr<int>, int, OwnerLess> ordered;
+        ordered[a] = 1;
+        ordered[b] = 2;
+        ordered[WeakPtr<int>(a)] = 3;
+        REQUIRE(ordered.size() == 2);
+        REQUIRE(ordered.find(a)->second == 3);
+        REQUIRE(OwnerLess()(a, b) != OwnerLess()(b, a));
+    }
+
+    SECTION("std::hash") {
+        auto a = MakeShared<int>(1);
+        SharedPtr<int> empty;
+        std::unordered_set<SharedPtr<int>> set{a, a, empty};
+        REQUIRE(set.size() == 2);
+        REQUIRE(std::hash<SharedPtr<int>>()(a) == std::hash<int*>()(a.Get()));
+    }
+}
@@ -0,0 +1,75 @@
+#include "shared.h"
+#include "weak.h"
+
+#include <catch.hpp>
+
+#include <string>
+
+struct Edge : StrongOnlyBase {
+    explicit Edge(int weight) : weight(weight) {
+        ++alive;
+    }
+    virtual ~Edge() {
+        --alive;
+    }
+
+    int weight;
+    inline static int alive = 0;
+};
+
+struct LabeledEdge : Edge {
+    LabeledEdge(int weight, std::string label) : Edge(weight), label(std::move(label)) {
+    }
+
+    std::string label;
+};
+
+struct Label {
+    std::string text;
+};
+
+template <>
+struct IsStrongOnly<Label> : std::true_type {};
+
+TEST_CASE("Strong-only control blocks") {
+    static_assert(sizeof(CBlockObj<Edge>) < sizeof(CBlockObj<std::pair<int, Edge*>>));
+    static_assert(kStrongOnly<const LabeledEdge>);
+    // Do not compile, strong-only and regular types have different control blocks:
+    //     auto edge = MakeShared<Edge>(1);
+    //     SharedPtr<int> weight(edge, &edge->weight);  // aliasing into a strong-only object
+    //     SharedPtr<Base> base = SharedPtr<Derived>();  // `IsStrongOnly` specialized for Derived only
+
+    SECTION("MakeShared") {
+        {
+            auto edge = MakeShared<Edge>(3);
+            SharedPtr<Edge> copy(edge);
+            SharedPtr<const Edge> view = copy;
+            REQUIRE(edge.UseCount() == 3);
+            REQUIRE(view->weight == 3);
+            edge.Reset();
+            copy.Reset();
+            REQUIRE(Edge::alive == 1);
+        }
+        REQUIRE(Edge::alive == 0);
+    }
+
+    SECTION("Raw pointers and conversions") {
+        {
+            SharedPtr<Edge> base(new LabeledEdge(1, "a"));
+            SharedPtr<LabeledEdge> derived = MakeShared<LabeledEdge>(2, "b");
+            base = derived;
+            REQUIRE(Edge::alive == 1);
+            REQUIRE(base->weight == 2);
+        }
+        REQUIRE(Edge::alive == 0);
+    }
+
+    SECTION("Specialized trait") {
+        static_assert(sizeof(CBlockPtr<Label>) == 2 * sizeof(void*) + sizeof(size_t));
+        auto label = MakeShared<Label>("strong");
+        SharedPtr<Label> other(new Label{"only"});
+        other = label;
+        REQUIRE(other->text == "strong");
+        REQUIRE(label.UseCount() == 2);
+    }
+}
@@ -0,0 +1,108 @@
+#include "thin.h"
+#include "weak.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+struct Vertex {
+    explicit Vertex(int id) : id(id) {
+        ++alive;
+    }
+    ~Vertex() {
+        --alive;
+    }
+
+    int id;
+    std::vector<ThinSharedPtr<Vertex>> edges;
+    inline static int alive = 0;
+};
+
+struct Arc : StrongOnlyBase {
+    int weight = 0;
+};
+
+struct Named : EnableSharedFromAddress<Named> {
+    std::string name;
+};
+
+TEST_CASE("Thin pointers") {
+    static_assert(sizeof(ThinSharedPtr<Vertex>) == sizeof(void*));
+    static_assert(sizeof(ThinWeakPtr<Vertex>) == sizeof(void*));
+
+    SECTION("Ownership") {
+        EXPECT_ONE_ALLOCATION(auto a = MakeThinShared<Vertex>(1));
+        {
+            auto a = MakeThinShared<Vertex>(1);
+            auto b = MakeThinShared<Vertex>(2);
+            a->edges.push_back(b);
+            b->edges.push_back(MakeThinShared<Vertex>(3));
+            REQUIRE(Vertex::alive == 3);
+            REQUIRE(b.UseCount() == 2);
+            REQUIRE(a->edges[0] == b);
+            REQUIRE((*b).edges[0]->id == 3);
+
+            b = a;
+            REQUIRE(a.UseCount() == 2);
+            REQUIRE(Vertex::alive == 3);
+            a.Reset();
+            REQUIRE(!a);
+            REQUIRE(a == nullptr);
+        }
+        REQUIRE(Vertex::alive == 0);
+    }
+
+    SECTION("Weak") {
+        ThinWeakPtr<Vertex> weak;
+        REQUIRE(weak.Expired());
+        REQUIRE(!weak.Lock());
+        {
+            auto a = MakeThinShared<Vertex>(1);
+            weak = a;
+            REQUIRE(weak.Lock() == a);
+            REQUIRE(weak.UseCount() == 1);
+            REQUIRE(weak.OwnerId() == a.OwnerId());
+        }
+        REQUIRE(Vertex::alive == 0);
+        REQUIRE(weak.Expired());
+        REQUIRE(!weak.Lock());
+    }
+
+    SECTION("Regular pointers") {
+        auto thin = MakeThinShared<Named>();
+        thin->name = "thin";
+        SharedPtr<Named> shared = thin.ToShared();
+        REQUIRE(shared.Get() == thin.Get());
+        REQUIRE(shared.OwnerId() == thin.OwnerId());
+        REQUIRE(thin.UseCount() == 2);
+
+        WeakPtr<Named> weak = shared;
+        thin.Reset();
+        REQUIRE(weak.Lock()->name == "thin");
+        REQUIRE(shared->SharedFromThis() == shared);
+        shared.Reset();
+        REQUIRE(weak.Expired());
+    }
+
+    SECTION("Strong-only types") {
+        // `ThinWeakPtr<Arc>` does not compile
+        auto thin = MakeThinShared<Arc>();
+        thin->weight = 5;
+        SharedPtr<Arc> shared = thin.ToShared();
+        REQUIRE(shared.UseCount() == 2);
+        thin.Reset();
+        REQUIRE(shared->weight == 5);
+        shared.Reset();
+    }
+
+    SECTION("Hash") {
+        auto a = MakeThinShared<Vertex>(1);
+        std::unordered_set<ThinSharedPtr<Vertex>> set{a, a, MakeThinShared<Vertex>(2)};
+        REQUIRE(set.size() == 2);
+        REQUIRE(set.count(a));
+    }
+}
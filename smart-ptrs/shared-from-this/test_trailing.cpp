@@ -0,0 +1,66 @@
+#include "trailing_shared.h"
+#include "weak.h"
+
+#include <catch.hpp>
+
+#include "allocations_checker.h"
+
+#include <algorithm>
+#include <string>
+
+struct Key : TrailingArray<Key, char> {
+    explicit Key(int tag) : tag(tag) {
+    }
+
+    std::string_view Name() const {
+        return {Tail(), TailSize()};
+    }
+
+    int tag;
+};
+
+struct Labels : TrailingArray<Labels, std::string> {
+    static inline int alive = 0;
+
+    Labels() {
+        ++alive;
+    }
+    ~Labels() {
+        --alive;
+    }
+};
+
+TEST_CASE("Shared with trailing storage") {
+    SECTION("One allocation") {
+        EXPECT_ONE_ALLOCATION(auto key = MakeSharedWithTrailing<Key>(16, 7));
+    }
+
+    SECTION("Tail") {
+        auto key = MakeSharedWithTrailing<Key, char>(5, 3);
+        REQUIRE(key->tag == 3);
+        REQUIRE(key->TailSize() == 5);
+        REQUIRE(reinterpret_cast<char*>(key->Tail()) >= reinterpret_cast<char*>(key.Get() + 1));
+        for (char& c : key->TailSpan()) {
+            REQUIRE(c == 0);
+        }
+        std::copy_n("hello", 5, key->Tail());
+        REQUIRE(key->Name() == "hello");
+    }
+
+    SECTION("Non-trivial tail") {
+        WeakPtr<Labels> weak;
+        {
+            auto labels = MakeSharedWithTrailing<Labels>(3);
+            labels->Tail()[2] = std::string(100, 'x');
+            weak = labels;
+            REQUIRE(Labels::alive == 1);
+        }
+        REQUIRE(weak.Expired());
+        REQUIRE(Labels::alive == 0);
+    }
+
+    SECTION("Empty tail") {
+        auto key = MakeSharedWithTrailing<Key>(0, 1);
+        REQUIRE(key->Name().empty());
+    }
+}
@@ -175,3 +175,18 @@ TEST_CASE("Lifetimes") {
         delete wp;
     }
 }
+
+TEST_CASE("TryLock") {
+    WeakPtr<std::string> wp;
+    REQUIRE(!wp.TryLock());
+    {
+        auto sp = MakeShared<std::string>("alive");
+        wp = sp;
+        auto locked = wp.TryLock();
+        REQUIRE(locked.Get() == sp.Get());
+        REQUIRE(sp.UseCount() == 2);
+    }
+    EXPECT_ZERO_ALLOCATIONS(REQUIRE(!wp.TryLock()));
+    REQUIRE(!wp.Lock());
+    REQUIRE_THROWS_AS(SharedPtr<std::string>(wp), BadWeakPtr);
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "shared.h"
+
+#include <cstddef>  // std::nullptr_t
+#include <functional>
+#include <utility>
+
+template <typename T>
+class ThinWeakPtr;
+
+// `SharedPtr` one pointer wide. The object always sits right behind a `CBlockHeader<T>`,
+// so only the block is stored and the object address is a constant offset away.
+// Objects come from `MakeThinShared`, there is no adopting of raw pointers and no
+// conversion to base classes. `EnableSharedFromAddress` works, the other mixins do not.
+template <typename T>
+class ThinSharedPtr {
+    template <typename Y>
+    friend class ThinWeakPtr;
+
+    template <typename Y, typename... Args>
+    friend ThinSharedPtr<Y> MakeThinShared(Args&&... args);
+
+public:
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Constructors
+
+    ThinSharedPtr() = default;
+    ThinSharedPtr(std::nullptr_t) {
+    }
+    ThinSharedPtr(const ThinSharedPtr& other) : block_(other.block_) {
+        if (block_) {
+            block_->IncStrongCounter();
+        }
+    }
+    ThinSharedPtr(ThinSharedPtr&& other) : block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // `operator=`-s
+
+    ThinSharedPtr& operator=(ThinSharedPtr other) {
+        Swap(other);
+        return *this;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Destructor
+
+    ~ThinSharedPtr() {
+        Reset();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    void Reset() {
+        if (block_) {
+            BaseBlock::ReleaseStrong(std::exchange(block_, nullptr));
+        }
+    }
+    void Swap(ThinSharedPtr& other) {
+        std::swap(block_, other.block_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    T* Get() const {
+        return block_ ? block_->GetObject() : nullptr;
+    }
+    T& operator*() const {
+        return *Get();
+    }
+    T* operator->() const {
+        return Get();
+    }
+    size_t UseCount() const {
+        return block_ ? block_->GetStrongCounter() : 0;
+    }
+    explicit operator bool() const {
+        return block_;
+    }
+    // Same as `SharedPtr::OwnerId`, equal for a thin pointer and the `SharedPtr` made from it.
+    const void* OwnerId() const {
+        return static_cast<const BaseBlock*>(block_);
+    }
+
+    // Shares ownership with a regular two-word pointer.
+    SharedPtr<T> ToShared() const {
+        return SharedPtr<T>::TryPromote(block_, Get());
+    }
+
+private:
+    // Takes over the single strong reference of a fresh block
+    explicit ThinSharedPtr(CBlockHeader<T>* block) : block_(block) {
+    }
+
+    CBlockHeader<T>* block_ = nullptr;
+};
+
+template <typename T, typename Y>
+bool operator==(const ThinSharedPtr<T>& left, const ThinSharedPtr<Y>& right) {
+    return left.Get() == right.Get();
+}
+
+template <typename T>
+bool operator==(const ThinSharedPtr<T>& left, std::nullptr_t) {
+    return !left;
+}
+
+template <typename T>
+struct std::hash<ThinSharedPtr<T>> {
+    size_t operator()(const ThinSharedPtr<T>& ptr) const {
+        return std::hash<T*>()(ptr.Get());
+    }
+};
+
+// `WeakPtr` counterpart of `ThinSharedPtr`, also one pointer wide.
+// Like `WeakPtr`, unavailable for strong-only types: a `SharedPtr` from `ToShared` releases
+// their block without looking at the weak count.
+template <typename T>
+class ThinWeakPtr {
+    static_assert(!kStrongOnly<T>, "T opted out of weak references, see StrongOnlyBase");
+
+public:
+    ThinWeakPtr() = default;
+    ThinWeakPtr(const ThinSharedPtr<T>& other) : block_(other.block_) {
+        IncBlock();
+    }
+    ThinWeakPtr(const ThinWeakPtr& other) : block_(other.block_) {
+        IncBlock();
+    }
+    ThinWeakPtr(ThinWeakPtr&& other) : block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    ThinWeakPtr& operator=(ThinWeakPtr other) {
+        Swap(other);
+        return *this;
+    }
+
+    ~ThinWeakPtr() {
+        Reset();
+    }
+
+    void Reset() {
+        if (block_) {
+            BaseBlock::ReleaseWeak(std::exchange(block_, nullptr));
+        }
+    }
+    void Swap(ThinWeakPtr& other) {
+        std::swap(block_, other.block_);
+    }
+
+    size_t UseCount() const {
+        return block_ ? block_->GetStrongCounter() : 0;
+    }
+    bool Expired() const {
+        return !UseCount();
+    }
+    const void* OwnerId() const {
+        return static_cast<const BaseBlock*>(block_);
+    }
+
+    // Empty pointer if expired. Never throws.
+    ThinSharedPtr<T> Lock() const {
+        if (block_ && block_->TryIncStrongCounter()) {
+            return ThinSharedPtr<T>(block_);
+        }
+        return nullptr;
+    }
+
+private:
+    void IncBlock() {
+        if (block_) {
+            block_->IncWeakCounter();
+        }
+    }
+
+    CBlockHeader<T>* block_ = nullptr;
+};
+
+template <typename T, typename... Args>
+ThinSharedPtr<T> MakeThinShared(Args&&... args) {
+    static_assert(!std::is_convertible<T*, EnableSharedFromThisBase*>::value &&
+                      !std::is_convertible<T*, EnableSharedFromBlockBase*>::value,
+                  "Thin pointers support EnableSharedFromAddress only");
+    return ThinSharedPtr<T>(CBlockHeader<T>::Create(std::forward<Args>(args)...));
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "shared.h"
+
+#include <common/trailing.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// `CBlockObj` followed by the tail of `T`: block, header and tail share one allocation.
+template <typename T>
+class CBlockTrailing : public BaseBlock {
+    using Tail = TrailingArray<T, typename T::TrailingElement>;
+
+protected:
+    std::aligned_storage_t<sizeof(T), alignof(T)> obj_;
+
+public:
+    template <typename... Args>
+    static CBlockTrailing* Create(size_t count, Args&&... args) {
+        static_assert(alignof(CBlockTrailing) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                      "T is over-aligned");
+        // `obj_` ends inside the block, so this covers the tail wherever the header lands
+        size_t bytes = sizeof(CBlockTrailing) - sizeof(T) + Tail::AllocationSize(count);
+        void* memory = ::operator new(bytes);
+        auto* block = ::new (memory) CBlockTrailing();
+        SMART_PTRS_TRY {
+            ::new (block->GetObject()) T(std::forward<Args>(args)...);
+        } SMART_PTRS_CATCH_ALL {
+            block->~CBlockTrailing();
+            ::operator delete(memory);
+            SMART_PTRS_RETHROW;
+        }
+        SMART_PTRS_TRY {
+            Tail::ConstructTail(block->GetObject(), count);
+        } SMART_PTRS_CATCH_ALL {
+            block->GetObject()->~T();
+            block->~CBlockTrailing();
+            ::operator delete(memory);
+            SMART_PTRS_RETHROW;
+        }
+        return block;
+    }
+
+    // Matches the unsized allocation in `Create`
+    static void operator delete(void* ptr) {
+        ::operator delete(ptr);
+    }
+
+    void DecStrongCounter() override {
+        strong_counter_ -= 1;
+        if (!strong_counter_) {
+            Tail::DestroyTail(GetObject());
+            GetObject()->~T();
+        }
+    }
+
+    T* GetObject() {
+        return reinterpret_cast<T*>(&obj_);
+    }
+
+private:
+    CBlockTrailing() = default;
+};
+
+// `MakeShared` for a `TrailingArray` type with `count` tail elements.
+template <typename T, typename Elem = typename T::TrailingElement, typename... Args>
+SharedPtr<T> MakeSharedWithTrailing(size_t count, Args&&... args) {
+    static_assert(std::is_base_of_v<TrailingArray<T, Elem>, T>,
+                  "T must derive from TrailingArray<T, Elem>");
+    static_assert(!std::is_convertible<T*, EnableSharedFromAddressBase*>::value,
+                  "EnableSharedFromAddress objects are created by MakeShared only");
+    CBlockTrailing<T>* block = CBlockTrailing<T>::Create(count, std::forward<Args>(args)...);
+    return SharedFromBlock(block, block->GetObject());
+}
@@ -6,6 +6,8 @@
 // https://en.cppreference.com/w/cpp/memory/weak_ptr
 template <typename T>
 class WeakPtr {
+    static_assert(!kStrongOnly<T>, "T opted out of weak references, see StrongOnlyBase");
+
     template <typename Y>
     friend class SharedPtr;
 
@@ -151,12 +153,34 @@ public:
         }
         return false;
     }
-    SharedPtr<T> Lock() const {
-        if (Expired()) {
-            return SharedPtr<T>();
-        } else {
-            return SharedPtr<T>(*this);
+    // Same as `SharedPtr::OwnerId`. Stays valid after expiry: the block lives while we do.
+    const void* OwnerId() const {
+        return block_;
+    }
+
+    // Same as `SharedPtr::OnExpired`, 0 if the object is gone already.
+    size_t OnExpired(std::function<void()> callback) const {
+        if (block_) {
+            return block_->AddExpiryListener(std::move(callback));
         }
+        return 0;
+    }
+    void CancelOnExpired(size_t id) const {
+        if (block_) {
+            block_->RemoveExpiryListener(id);
+        }
+    }
+    // Empty pointer if expired. Never throws.
+    SharedPtr<T> TryLock() const {
+        SharedPtr<T> result;
+        if (block_ && block_->TryIncStrongCounter()) {
+            result.block_ = block_;
+            result.observer_ = observer_;
+        }
+        return result;
+    }
+    SharedPtr<T> Lock() const {
+        return TryLock();
     }
 
 private:
@@ -169,12 +193,7 @@ private:
     }
     void DecBlock() {
         if (block_) {
-            block_->DecWeakCounter();
-            if (block_->GetStrongCounter() == 0 && block_->GetWeakCounter() == 0) {
-                delete block_;
-                block_ = nullptr;
-            }
+            BaseBlock::ReleaseWeak(block_);
         }
-        // надо что то еще?
     }
 };
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "unique.h"
+
+#include <common/exceptions.h>
+
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+// Arrays of trivially destructible elements need no state to be released,
+// so `UniquePtr<T[], AlignedDelete<T>>` stays one pointer wide for them.
+template <typename T, bool = std::is_trivially_destructible_v<T>>
+class AlignedDelete {
+public:
+    AlignedDelete() = default;
+    explicit AlignedDelete(size_t) {
+    }
+    void operator()(T* ptr) {
+        std::free(ptr);
+    }
+};
+
+template <typename T>
+class AlignedDelete<T, false> {
+public:
+    AlignedDelete() = default;
+    explicit AlignedDelete(size_t count) : count_(count) {
+    }
+    void operator()(T* ptr) {
+        for (size_t i = count_; i-- > 0;) {
+            ptr[i].~T();
+        }
+        std::free(ptr);
+    }
+
+private:
+    size_t count_ = 0;
+};
+
+// Unmaps a huge-page backed array. The mapping length is derived from the element count.
+template <typename T>
+class HugePageDelete {
+public:
+    static constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+    HugePageDelete() = default;
+    explicit HugePageDelete(size_t count) : count_(count) {
+    }
+    void operator()(T* ptr) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = count_; i-- > 0;) {
+                ptr[i].~T();
+            }
+        }
+        munmap(ptr, MappingLength(count_));
+    }
+
+    // Largest count whose mapping, plus the page trimmed off for alignment, fits in size_t
+    static constexpr size_t kMaxCount =
+        (std::numeric_limits<size_t>::max() - 2 * kHugePageSize) / sizeof(T);
+
+    static size_t MappingLength(size_t count) {
+        size_t bytes = count ? count * sizeof(T) : 1;
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+private:
+    size_t count_ = 0;
+};
+
+// Value-initializes `count` elements in raw storage, undoing the work if a constructor throws.
+template <typename T>
+void ConstructArray(T* ptr, size_t count) {
+    size_t i = 0;
+    SMART_PTRS_TRY {
+        for (; i < count; ++i) {
+            ::new (ptr + i) T();
+        }
+    } SMART_PTRS_CATCH_ALL {
+        while (i-- > 0) {
+            ptr[i].~T();
+        }
+        SMART_PTRS_RETHROW;
+    }
+}
+
+// `new T[n]()` with the array aligned to `alignment`, a power of two not less than `alignof(T)`.
+// Empty if the alignment is invalid, `count` elements overflow size_t, or the memory is not
+// available.
+template <typename T>
+UniquePtr<T, AlignedDelete<std::remove_extent_t<T>>> TryMakeUniqueAligned(size_t count,
+                                                                           size_t alignment) {
+    static_assert(std::is_unbounded_array_v<T>, "MakeUniqueAligned is for T[] only");
+    using Elem = std::remove_extent_t<T>;
+
+    if (alignment < alignof(Elem) || (alignment & (alignment - 1))) {
+        return UniquePtr<T, AlignedDelete<Elem>>();
+    }
+    if (count > (std::numeric_limits<size_t>::max() - alignment) / sizeof(Elem)) {
+        return UniquePtr<T, AlignedDelete<Elem>>();
+    }
+    // aligned_alloc wants the size to be a multiple of the alignment
+    size_t bytes = (count * sizeof(Elem) + alignment - 1) / alignment * alignment;
+    auto* ptr = static_cast<Elem*>(std::aligned_alloc(alignment, bytes ? bytes : alignment));
+    if (!ptr) {
+        return UniquePtr<T, AlignedDelete<Elem>>();
+    }
+    if constexpr (std::is_trivially_default_constructible_v<Elem>) {
+        std::memset(ptr, 0, count * sizeof(Elem));
+    } else {
+        SMART_PTRS_TRY {
+            ConstructArray(ptr, count);
+        } SMART_PTRS_CATCH_ALL {
+            std::free(ptr);
+            SMART_PTRS_RETHROW;
+        }
+    }
+    return UniquePtr<T, AlignedDelete<Elem>>(ptr, AlignedDelete<Elem>(count));
+}
+
+// Throwing `TryMakeUniqueAligned`: std::invalid_argument for a bad alignment, std::bad_alloc
+// if out of memory or `count` is too large.
+template <typename T>
+UniquePtr<T, AlignedDelete<std::remove_extent_t<T>>> MakeUniqueAligned(size_t count,
+                                                                        size_t alignment) {
+    using Elem = std::remove_extent_t<T>;
+    if (alignment < alignof(Elem) || (alignment & (alignment - 1))) {
+        SMART_PTRS_THROW(
+            std::invalid_argument("alignment must be a power of two not less than alignof(T)"));
+    }
+    auto result = TryMakeUniqueAligned<T>(count, alignment);
+    if (!result) {
+        SMART_PTRS_THROW(std::bad_alloc());
+    }
+    return result;
+}
+
+// `new T[n]()` placed in an anonymous mapping advised for transparent huge pages.
+// The advice is best effort: the buffer is usable even if THP is disabled.
+// Empty if `count` elements overflow size_t or the mapping cannot be created.
+template <typename T>
+UniquePtr<T, HugePageDelete<std::remove_extent_t<T>>> TryMakeUniqueHugePages(size_t count) {
+    static_assert(std::is_unbounded_array_v<T>, "MakeUniqueHugePages is for T[] only");
+    using Elem = std::remove_extent_t<T>;
+    static_assert(alignof(Elem) <= HugePageDelete<Elem>::kHugePageSize);
+
+    constexpr size_t kPage = HugePageDelete<Elem>::kHugePageSize;
+    if (count > HugePageDelete<Elem>::kMaxCount) {
+        return UniquePtr<T, HugePageDelete<Elem>>();
+    }
+    size_t length = HugePageDelete<Elem>::MappingLength(count);
+    // Over-map by one huge page and trim, so the buffer starts on a huge page boundary
+    void* raw = mmap(nullptr, length + kPage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                     -1, 0);
+    if (raw == MAP_FAILED) {
+        return UniquePtr<T, HugePageDelete<Elem>>();
+    }
+    char* begin = static_cast<char*>(raw);
+    char* aligned = reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(begin) + kPage - 1) / kPage * kPage);
+    if (aligned != begin) {
+        munmap(begin, aligned - begin);
+    }
+    if (size_t tail = begin + length + kPage - (aligned + length)) {
+        munmap(aligned + length, tail);
+    }
+    void* addr = aligned;
+#ifdef MADV_HUGEPAGE
+    madvise(addr, length, MADV_HUGEPAGE);
+#endif
+    auto* ptr = static_cast<Elem*>(addr);
+    // Fresh anonymous pages are already zero
+    if constexpr (!std::is_trivially_default_constructible_v<Elem>) {
+        SMART_PTRS_TRY {
+            ConstructArray(ptr, count);
+        } SMART_PTRS_CATCH_ALL {
+            munmap(addr, length);
+            SMART_PTRS_RETHROW;
+        }
+    }
+    return UniquePtr<T, HugePageDelete<Elem>>(ptr, HugePageDelete<Elem>(count));
+}
+
+// Throwing `TryMakeUniqueHugePages`: std::bad_alloc if the mapping cannot be created.
+template <typename T>
+UniquePtr<T, HugePageDelete<std::remove_extent_t<T>>> MakeUniqueHugePages(size_t count) {
+    auto result = TryMakeUniqueHugePages<T>(count);
+    if (!result) {
+        SMART_PTRS_THROW(std::bad_alloc());
+    }
+    return result;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "unique.h"
+
+#include <pool/arena.h>
+
+#include <type_traits>
+#include <utility>
+
+// Only runs the destructor: the memory belongs to the arena and goes away on `Arena::Reset`.
+// The pointer must not outlive the next reset of its arena.
+template <typename T>
+class ArenaDeleter {
+public:
+    void operator()(T* ptr) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            ptr->~T();
+        }
+    }
+};
+
+template <typename T, typename... Args>
+UniquePtr<T, ArenaDeleter<T>> MakeArenaUnique(Arena& arena, Args&&... args) {
+    void* place = arena.Allocate(sizeof(T), alignof(T));
+    return UniquePtr<T, ArenaDeleter<T>>(::new (place) T(std::forward<Args>(args)...));
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "arena_unique.h"
+
+#include <common/compressed.h>
+
+#include <cstddef>  // std::nullptr_t
+#include <cstdint>
+#include <utility>
+
+// `UniquePtr` into a `CompressedSpace`, four bytes wide. Like `ArenaDeleter`, releasing only
+// runs the destructor, the memory goes back with a reset of the space's region.
+template <typename T, typename Space>
+class CompressedUniquePtr {
+public:
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Constructors
+
+    CompressedUniquePtr() = default;
+    CompressedUniquePtr(std::nullptr_t) {
+    }
+    explicit CompressedUniquePtr(T* ptr) : ptr_(ptr) {
+    }
+    CompressedUniquePtr(CompressedUniquePtr&& other) noexcept : ptr_(other.Release()) {
+    }
+    CompressedUniquePtr(const CompressedUniquePtr&) = delete;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // `operator=`-s
+
+    CompressedUniquePtr& operator=(CompressedUniquePtr&& other) noexcept {
+        Reset(other.Release());
+        return *this;
+    }
+    CompressedUniquePtr& operator=(std::nullptr_t) {
+        Reset();
+        return *this;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Destructor
+
+    ~CompressedUniquePtr() {
+        Reset();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    T* Release() {
+        return std::exchange(ptr_, nullptr).Get();
+    }
+    void Reset(T* ptr = nullptr) {
+        T* old_ptr = ptr_.Get();
+        ptr_ = CompressedPtr<T, Space>(ptr);
+        if (old_ptr) {
+            ArenaDeleter<T>()(old_ptr);
+        }
+    }
+    void Swap(CompressedUniquePtr& other) {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    T* Get() const {
+        return ptr_.Get();
+    }
+    explicit operator bool() const {
+        return static_cast<bool>(ptr_);
+    }
+    T& operator*() const {
+        return *Get();
+    }
+    T* operator->() const {
+        return Get();
+    }
+
+private:
+    CompressedPtr<T, Space> ptr_;
+};
+
+template <typename T, typename Space, typename... Args>
+CompressedUniquePtr<T, Space> MakeCompressedUnique(Args&&... args) {
+    void* place = Space::Allocate(sizeof(T), alignof(T));
+    return CompressedUniquePtr<T, Space>(::new (place) T(std::forward<Args>(args)...));
+}
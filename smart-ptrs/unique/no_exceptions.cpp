@@ -0,0 +1,38 @@
+// Compiled with -fno-exceptions: instantiates the throwing paths of every header in this directory.
+
+#include "aligned.h"
+#include "arena_unique.h"
+#include "compressed_unique.h"
+#include "pooled.h"
+#include "sized.h"
+#include "tagged_unique.h"
+#include "unique.h"
+
+#include <string>
+
+struct UniqueNode {
+    std::string name;
+};
+
+struct UniqueSpaceTag {};
+
+void CheckUniqueNoExceptions() {
+    auto aligned = TryMakeUniqueAligned<UniqueNode[]>(4, 64);
+    auto thrown = MakeUniqueAligned<UniqueNode[]>(4, 64);
+    auto huge = TryMakeUniqueHugePages<UniqueNode[]>(4);
+
+    StoragePool<UniqueNode> pool;
+    auto pooled = MakePooledUnique<UniqueNode>(pool);
+    auto local = MakeLocalPooledUnique<UniqueNode>();
+
+    Arena arena;
+    auto in_arena = MakeArenaUnique<UniqueNode>(arena);
+    auto compressed = MakeCompressedUnique<UniqueNode, CompressedSpace<UniqueSpaceTag>>();
+
+    TaggedUniquePtr<UniqueNode, 1> tagged(new UniqueNode(), 1);
+
+    SizedUniqueArray<int> heap;
+    heap.Resize(16);
+    MmapSizedUniqueArray<int> mapped;
+    mapped.Resize(16);
+}
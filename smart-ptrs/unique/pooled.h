@@ -0,0 +1,59 @@
+#pragma once
+
+#include "unique.h"
+
+#include <pool/storage_pool.h>
+
+#include <utility>
+
+// Destroys the object and hands its storage back to the pool it came from.
+template <typename T>
+class PoolDeleter {
+public:
+    PoolDeleter() = default;
+    explicit PoolDeleter(StoragePool<T>* pool) : pool_(pool) {
+    }
+    void operator()(T* ptr) {
+        ptr->~T();
+        pool_->Release(ptr);
+    }
+
+    StoragePool<T>* GetPool() const {
+        return pool_;
+    }
+
+private:
+    StoragePool<T>* pool_ = nullptr;
+};
+
+// Same as `PoolDeleter`, but always returns storage to `StoragePool<T>::Local()`
+// of the destroying thread. Stateless, so the owning `UniquePtr` stays one pointer wide.
+// The pointer has to die on the thread that made it, before that thread exits: elsewhere
+// the slot lands in a foreign pool, after exit in a destroyed one. Debug builds only assert
+// when the destroying thread's pool has nothing in use, or when a thread exits with slots
+// of its pool still out; a release after the exit goes unnoticed. Use `PoolDeleter` for
+// pointers that travel.
+template <typename T>
+class LocalPoolDeleter {
+public:
+    void operator()(T* ptr) {
+        ptr->~T();
+        StoragePool<T>::Local().Release(ptr);
+    }
+};
+
+template <typename T, typename Deleter, typename... Args>
+UniquePtr<T, Deleter> ConstructPooled(StoragePool<T>& pool, Deleter deleter, Args&&... args) {
+    return UniquePtr<T, Deleter>(pool.Construct(std::forward<Args>(args)...), std::move(deleter));
+}
+
+template <typename T, typename... Args>
+UniquePtr<T, PoolDeleter<T>> MakePooledUnique(StoragePool<T>& pool, Args&&... args) {
+    return ConstructPooled<T>(pool, PoolDeleter<T>(&pool), std::forward<Args>(args)...);
+}
+
+template <typename T, typename... Args>
+UniquePtr<T, LocalPoolDeleter<T>> MakeLocalPooledUnique(Args&&... args) {
+    return ConstructPooled<T>(StoragePool<T>::Local(), LocalPoolDeleter<T>(),
+                              std::forward<Args>(args)...);
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "unique.h"
+
+#include <common/exceptions.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <span>
+#include <type_traits>
+
+// Backings decide where the bytes of a `SizedUniqueArray` live.
+// `Reallocate` keeps the old contents and guarantees zeroes in [old_bytes, new_bytes).
+// `kAlignment` is the alignment every returned address has.
+
+// malloc/realloc: realloc may extend in place, only the grown tail is cleared.
+struct HeapBacking {
+    static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+    static void* Allocate(size_t bytes) {
+        if (!bytes) {
+            return nullptr;
+        }
+        void* ptr = std::calloc(bytes, 1);
+        if (!ptr) {
+            SMART_PTRS_THROW(std::bad_alloc());
+        }
+        return ptr;
+    }
+    static void* Reallocate(void* ptr, size_t old_bytes, size_t new_bytes) {
+        if (!new_bytes) {
+            Free(ptr, old_bytes);
+            return nullptr;
+        }
+        void* result = std::realloc(ptr, new_bytes);
+        if (!result) {
+            SMART_PTRS_THROW(std::bad_alloc());
+        }
+        if (new_bytes > old_bytes) {
+            std::memset(static_cast<char*>(result) + old_bytes, 0, new_bytes - old_bytes);
+        }
+        return result;
+    }
+    static void Free(void* ptr, size_t) {
+        std::free(ptr);
+    }
+};
+
+// Anonymous mappings grown with mremap: the kernel moves page tables instead of copying data.
+// Pages past the old mapping are fresh zero pages, only the old partial page is cleared.
+struct MmapBacking {
+    static constexpr size_t kAlignment = 4096;  // the smallest page size
+
+    static size_t MappingLength(size_t bytes) {
+        static const size_t kPageSize = sysconf(_SC_PAGESIZE);
+        return (bytes + kPageSize - 1) / kPageSize * kPageSize;
+    }
+    static void* Allocate(size_t bytes) {
+        if (!bytes) {
+            return nullptr;
+        }
+        void* ptr = mmap(nullptr, MappingLength(bytes), PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            SMART_PTRS_THROW(std::bad_alloc());
+        }
+        return ptr;
+    }
+    static void* Reallocate(void* ptr, size_t old_bytes, size_t new_bytes) {
+        if (!ptr || !new_bytes) {
+            Free(ptr, old_bytes);
+            return Allocate(new_bytes);
+        }
+        size_t old_length = MappingLength(old_bytes);
+        size_t new_length = MappingLength(new_bytes);
+        void* result = ptr;
+        if (old_length != new_length) {
+            result = mremap(ptr, old_length, new_length, MREMAP_MAYMOVE);
+            if (result == MAP_FAILED) {
+                SMART_PTRS_THROW(std::bad_alloc());
+            }
+        }
+        if (new_bytes > old_bytes) {
+            size_t dirty_end = new_bytes < old_length ? new_bytes : old_length;
+            if (dirty_end > old_bytes) {
+                std::memset(static_cast<char*>(result) + old_bytes, 0, dirty_end - old_bytes);
+            }
+        }
+        return result;
+    }
+    static void Free(void* ptr, size_t bytes) {
+        if (ptr) {
+            munmap(ptr, MappingLength(bytes));
+        }
+    }
+};
+
+// Frees through the backing. Keeps the element count, which doubles as the array length.
+template <typename T, typename Backing>
+class BackingDelete {
+public:
+    BackingDelete() = default;
+    explicit BackingDelete(size_t count) : count_(count) {
+    }
+    void operator()(T* ptr) {
+        Backing::Free(ptr, count_ * sizeof(T));
+    }
+
+    size_t Count() const {
+        return count_;
+    }
+
+private:
+    size_t count_ = 0;
+};
+
+// `UniquePtr<T[]>` that knows its length. Elements are zero-initialized.
+template <typename T, typename Backing = HeapBacking>
+class SizedUniqueArray {
+    static_assert(std::is_trivially_copyable_v<T>, "Resize moves elements bytewise");
+    static_assert(alignof(T) <= Backing::kAlignment, "The backing cannot align T");
+
+    using Deleter = BackingDelete<T, Backing>;
+
+public:
+    SizedUniqueArray() = default;
+    explicit SizedUniqueArray(size_t size)
+        : data_(static_cast<T*>(Backing::Allocate(Bytes(size))), Deleter(size)) {
+    }
+    // The length lives in the deleter, a moved-from array has to lose it along with the data
+    SizedUniqueArray(SizedUniqueArray&& other) noexcept {
+        Swap(other);
+    }
+    SizedUniqueArray& operator=(SizedUniqueArray&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            Swap(other);
+        }
+        return *this;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    // Grows or shrinks in place when the backing allows it. New elements are zero.
+    void Resize(size_t size) {
+        T* ptr = static_cast<T*>(Backing::Reallocate(Data(), Size() * sizeof(T), Bytes(size)));
+        // The old buffer is gone on success and untouched on failure
+        data_.Release();
+        data_.GetDeleter() = Deleter(size);
+        data_.Reset(ptr);
+    }
+    void Reset() {
+        data_.Reset();
+        data_.GetDeleter() = Deleter();
+    }
+    void Swap(SizedUniqueArray& other) {
+        data_.Swap(other.data_);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    T* Data() const {
+        return data_.Get();
+    }
+    size_t Size() const {
+        return data_.GetDeleter().Count();
+    }
+    bool Empty() const {
+        return !Size();
+    }
+    T& operator[](size_t i) const {
+        return data_[i];
+    }
+    T* begin() const {
+        return Data();
+    }
+    T* end() const {
+        return Data() + Size();
+    }
+
+    std::span<T> Span() const {
+        return {Data(), Size()};
+    }
+    operator std::span<T>() const {
+        return Span();
+    }
+    operator std::span<const T>() const {
+        return Span();
+    }
+
+private:
+    // std::bad_alloc for sizes no allocation can hold, before the multiplication wraps
+    static size_t Bytes(size_t size) {
+        if (size > static_cast<size_t>(std::numeric_limits<ptrdiff_t>::max()) / sizeof(T)) {
+            SMART_PTRS_THROW(std::bad_alloc());
+        }
+        return size * sizeof(T);
+    }
+
+    UniquePtr<T[], Deleter> data_;
+};
+
+template <typename T>
+using MmapSizedUniqueArray = SizedUniqueArray<T, MmapBacking>;
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "unique.h"
+
+#include <common/tagged.h>
+
+#include <cstddef>  // std::nullptr_t
+#include <cstdint>
+#include <utility>
+
+// `UniquePtr` with `Bits` flags in the low bits of the pointer, one word with an empty deleter.
+// `Release` and `Reset` keep the tag of the pointer they are called on. Moves carry the tag
+// along with the object: the target takes the tag of the source, which keeps its own.
+template <typename T, size_t Bits, typename Deleter = DefaultDelete<T>>
+class TaggedUniquePtr {
+    using Word = TaggedPointer<T, Bits>;
+
+public:
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Constructors
+
+    TaggedUniquePtr() = default;
+    explicit TaggedUniquePtr(T* ptr, uintptr_t tag = 0) : inner_(Word(ptr, tag), Deleter()) {
+    }
+    TaggedUniquePtr(UniquePtr<T, Deleter>&& other, uintptr_t tag = 0)
+        : inner_(Word(other.Get(), tag), std::move(other.GetDeleter())) {
+        other.Release();
+    }
+    TaggedUniquePtr(TaggedUniquePtr&& other) noexcept
+        : inner_(Word(other.Release(), other.GetTag()), std::move(other.GetDeleter())) {
+    }
+    TaggedUniquePtr(const TaggedUniquePtr&) = delete;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // `operator=`-s
+
+    // Takes the pointer and the tag of `other`
+    TaggedUniquePtr& operator=(TaggedUniquePtr&& other) noexcept {
+        uintptr_t tag = other.GetTag();
+        Reset(other.Release());
+        SetTag(tag);
+        GetDeleter() = std::move(other.GetDeleter());
+        return *this;
+    }
+    TaggedUniquePtr& operator=(std::nullptr_t) {
+        Reset();
+        return *this;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Destructor
+
+    ~TaggedUniquePtr() {
+        Reset();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Modifiers
+
+    T* Release() {
+        T* ptr = Get();
+        inner_.GetFirst().SetPointer(nullptr);
+        return ptr;
+    }
+    void Reset(T* ptr = nullptr) {
+        T* old_ptr = Get();
+        inner_.GetFirst().SetPointer(ptr);
+        if (old_ptr) {
+            GetDeleter()(old_ptr);
+        }
+    }
+    void SetTag(uintptr_t tag) {
+        inner_.GetFirst().SetTag(tag);
+    }
+    void Swap(TaggedUniquePtr& other) {
+        std::swap(inner_.GetFirst(), other.inner_.GetFirst());
+        std::swap(GetDeleter(), other.GetDeleter());
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // Observers
+
+    T* Get() const {
+        return inner_.GetFirst().Get();
+    }
+    uintptr_t GetTag() const {
+        return inner_.GetFirst().GetTag();
+    }
+    Deleter& GetDeleter() {
+        return inner_.GetSecond();
+    }
+    const Deleter& GetDeleter() const {
+        return inner_.GetSecond();
+    }
+    explicit operator bool() const {
+        return Get();
+    }
+
+    T& operator*() const {
+        return *Get();
+    }
+    T* operator->() const {
+        return Get();
+    }
+
+private:
+    CompressedPair<Word, Deleter> inner_;
+};
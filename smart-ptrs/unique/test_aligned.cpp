@@ -0,0 +1,86 @@
+#include "aligned.h"
+
+#include <common/my_int.h>
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <limits>
+
+template <typename T>
+bool IsAligned(T* ptr, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST_CASE("Aligned arrays") {
+    SECTION("Sizeof") {
+        static_assert(sizeof(UniquePtr<float[], AlignedDelete<float>>) == sizeof(void*));
+        static_assert(sizeof(UniquePtr<MyInt[], AlignedDelete<MyInt>>) == 2 * sizeof(void*));
+    }
+
+    SECTION("Alignment and zeroing") {
+        for (size_t alignment : {8, 64, 4096}) {
+            auto buf = MakeUniqueAligned<float[]>(100, alignment);
+            REQUIRE(IsAligned(buf.Get(), alignment));
+            for (size_t i = 0; i < 100; ++i) {
+                REQUIRE(buf[i] == 0.0f);
+            }
+            buf[99] = 1.0f;
+        }
+    }
+
+    SECTION("Bad alignment") {
+        REQUIRE_THROWS_AS(MakeUniqueAligned<double[]>(10, 48), std::invalid_argument);
+        REQUIRE_THROWS_AS(MakeUniqueAligned<double[]>(10, 4), std::invalid_argument);
+        REQUIRE(!TryMakeUniqueAligned<double[]>(10, 48));
+        REQUIRE(TryMakeUniqueAligned<double[]>(10, 64));
+    }
+
+    SECTION("Overflowing count") {
+        constexpr size_t kHuge = std::numeric_limits<size_t>::max() / 4 + 1;
+        REQUIRE(!TryMakeUniqueAligned<float[]>(kHuge, 64));
+        REQUIRE_THROWS_AS(MakeUniqueAligned<float[]>(kHuge, 64), std::bad_alloc);
+    }
+
+    SECTION("Non-trivial elements") {
+        {
+            auto arr = MakeUniqueAligned<MyInt[]>(17, 64);
+            REQUIRE(IsAligned(arr.Get(), 64));
+            REQUIRE(MyInt::AliveCount() == 17);
+        }
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+}
+
+TEST_CASE("Huge page arrays") {
+    SECTION("Trivial elements") {
+        auto buf = MakeUniqueHugePages<float[]>(1 << 20);
+        REQUIRE(IsAligned(buf.Get(), HugePageDelete<float>::kHugePageSize));
+        REQUIRE(buf[0] == 0.0f);
+        REQUIRE(buf[(1 << 20) - 1] == 0.0f);
+        buf[12345] = 3.0f;
+        REQUIRE(buf[12345] == 3.0f);
+    }
+
+    SECTION("Non-trivial elements") {
+        {
+            auto arr = MakeUniqueHugePages<MyInt[]>(1000);
+            REQUIRE(MyInt::AliveCount() == 1000);
+            arr.Reset();
+            REQUIRE(MyInt::AliveCount() == 0);
+        }
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+
+    SECTION("Overflowing count") {
+        REQUIRE(!TryMakeUniqueHugePages<MyInt[]>(std::numeric_limits<size_t>::max() / 2));
+        REQUIRE_THROWS_AS(MakeUniqueHugePages<float[]>(std::numeric_limits<size_t>::max() / 4),
+                          std::bad_alloc);
+    }
+
+    SECTION("Empty") {
+        auto arr = MakeUniqueHugePages<MyInt[]>(0);
+        REQUIRE(arr);
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+}
@@ -0,0 +1,84 @@
+#include "arena_unique.h"
+
+#include <common/my_int.h>
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <string>
+
+TEST_CASE("Arena") {
+    SECTION("Bump") {
+        Arena arena(128);
+        auto* a = static_cast<char*>(arena.Allocate(8, 8));
+        auto* b = static_cast<char*>(arena.Allocate(8, 8));
+        REQUIRE(b == a + 8);
+        REQUIRE(arena.BytesUsed() == 16);
+        REQUIRE(arena.BytesReserved() == 128);
+    }
+
+    SECTION("Alignment") {
+        Arena arena(256);
+        arena.Allocate(1, 1);
+        void* p = arena.Allocate(16, 64);
+        REQUIRE(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+    }
+
+    SECTION("Chained blocks") {
+        Arena arena(64);
+        for (int i = 0; i < 100; ++i) {
+            arena.Allocate(16, 8);
+        }
+        REQUIRE(arena.BytesUsed() == 1600);
+        REQUIRE(arena.BytesReserved() >= 1600);
+
+        void* big = arena.Allocate(1000, 8);
+        REQUIRE(big != nullptr);
+    }
+
+    SECTION("Reset reuses blocks") {
+        Arena arena(64);
+        void* first = arena.Allocate(16, 8);
+        for (int i = 0; i < 20; ++i) {
+            arena.Allocate(16, 8);
+        }
+        size_t reserved = arena.BytesReserved();
+
+        arena.Reset();
+        REQUIRE(arena.BytesUsed() == 0);
+        REQUIRE(arena.Allocate(16, 8) == first);
+        for (int i = 0; i < 20; ++i) {
+            arena.Allocate(16, 8);
+        }
+        REQUIRE(arena.BytesReserved() == reserved);
+    }
+}
+
+TEST_CASE("Arena unique") {
+    SECTION("Sizeof") {
+        static_assert(sizeof(UniquePtr<std::string, ArenaDeleter<std::string>>) == sizeof(void*));
+    }
+
+    SECTION("Destructor runs") {
+        Arena arena;
+        {
+            auto a = MakeArenaUnique<MyInt>(arena, 1);
+            auto b = MakeArenaUnique<MyInt>(arena, 2);
+            REQUIRE(MyInt::AliveCount() == 2);
+            REQUIRE(*a == 1);
+            a.Reset();
+            REQUIRE(MyInt::AliveCount() == 1);
+        }
+        REQUIRE(MyInt::AliveCount() == 0);
+        arena.Reset();
+    }
+
+    SECTION("Objects live in the arena") {
+        Arena arena;
+        auto s = MakeArenaUnique<std::string>(arena, 100, 'x');
+        auto n = MakeArenaUnique<int>(arena, 42);
+        REQUIRE(*s == std::string(100, 'x'));
+        REQUIRE(*n == 42);
+        REQUIRE(arena.BytesUsed() >= sizeof(std::string) + sizeof(int));
+    }
+}
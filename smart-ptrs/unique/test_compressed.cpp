@@ -0,0 +1,86 @@
+#include "compressed_unique.h"
+
+#include <common/my_int.h>
+
+#include <catch.hpp>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct ListTag {};
+using ListSpace = CompressedSpace<ListTag, 3>;
+
+struct ListNode {
+    explicit ListNode(std::string value) : value(std::move(value)) {
+    }
+
+    std::string value;
+    CompressedUniquePtr<ListNode, ListSpace> next;
+};
+
+TEST_CASE("Compressed UniquePtr") {
+    static_assert(sizeof(CompressedUniquePtr<MyInt, ListSpace>) == 4);
+
+    SECTION("Region") {
+        Region region(1 << 20);
+        void* first = region.Allocate(8, 8);
+        REQUIRE(first != region.Base());
+        REQUIRE(region.Contains(first));
+        REQUIRE(!region.TryAllocate(1 << 20, 8));
+        region.Reset();
+        REQUIRE(region.Allocate(8, 8) == first);
+    }
+
+    SECTION("Offsets") {
+        auto ptr = MakeCompressedUnique<MyInt, ListSpace>(5);
+        CompressedPtr<MyInt, ListSpace> view(ptr.Get());
+        REQUIRE(view.Get() == ptr.Get());
+        REQUIRE(view.Offset() != 0);
+        REQUIRE(ListSpace::GetRegion().Contains(ptr.Get()));
+        REQUIRE(*ptr == 5);
+    }
+
+    SECTION("Ownership") {
+        {
+            auto head = MakeCompressedUnique<ListNode, ListSpace>("a");
+            head->next = MakeCompressedUnique<ListNode, ListSpace>("b");
+            head->next->next = MakeCompressedUnique<ListNode, ListSpace>(std::string(100, 'c'));
+            REQUIRE(head->next->next->value.size() == 100);
+
+            auto second = std::move(head->next);
+            REQUIRE(!head->next);
+            REQUIRE(second->value == "b");
+
+            auto own = MakeCompressedUnique<MyInt, ListSpace>(1);
+            own.Reset();
+            REQUIRE(MyInt::AliveCount() == 0);
+            own = MakeCompressedUnique<MyInt, ListSpace>(2);
+        }
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+
+    SECTION("Concurrent allocation") {
+        constexpr int kThreads = 4;
+        constexpr int kPerThread = 1000;
+        std::vector<std::vector<void*>> places(kThreads);
+        std::vector<std::thread> threads;
+        for (auto& mine : places) {
+            threads.emplace_back([&mine] {
+                for (int i = 0; i < kPerThread; ++i) {
+                    mine.push_back(ListSpace::Allocate(8, 8));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        std::set<void*> distinct;
+        for (const auto& mine : places) {
+            distinct.insert(mine.begin(), mine.end());
+        }
+        REQUIRE(distinct.size() == kThreads * kPerThread);
+    }
+}
@@ -0,0 +1,103 @@
+#include "pooled.h"
+
+#include <common/my_int.h>
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+struct Message {
+    Message(int id, std::string body) : id(id), body(std::move(body)) {
+    }
+    Message(const Message&) = delete;
+    Message(Message&&) = default;
+
+    int id;
+    std::string body;
+};
+
+TEST_CASE("Pooled unique") {
+    SECTION("Sizeof") {
+        static_assert(sizeof(UniquePtr<Message, LocalPoolDeleter<Message>>) == sizeof(void*));
+        static_assert(sizeof(UniquePtr<Message, PoolDeleter<Message>>) == 2 * sizeof(void*));
+    }
+
+    SECTION("Reuse storage") {
+        StoragePool<Message> pool;
+        Message* first;
+        {
+            auto msg = MakePooledUnique<Message>(pool, 1, "hello");
+            REQUIRE(msg->id == 1);
+            REQUIRE(msg->body == "hello");
+            REQUIRE(pool.NumInUse() == 1);
+            first = msg.Get();
+        }
+        REQUIRE(pool.NumInUse() == 0);
+        REQUIRE(pool.NumAvailable() == 1);
+
+        auto msg = MakePooledUnique<Message>(pool, 2, "world");
+        REQUIRE(msg.Get() == first);
+        REQUIRE(msg->id == 2);
+
+        auto stats = pool.Stats();
+        REQUIRE(stats.allocations == 1);
+        REQUIRE(stats.reuses == 1);
+        REQUIRE(stats.misses == 1);
+    }
+
+    SECTION("Lifetime") {
+        StoragePool<MyInt> pool;
+        {
+            auto a = MakePooledUnique<MyInt>(pool, 1);
+            auto b = MakePooledUnique<MyInt>(pool, 2);
+            REQUIRE(MyInt::AliveCount() == 2);
+            b = std::move(a);
+            REQUIRE(MyInt::AliveCount() == 1);
+            REQUIRE(*b == 1);
+        }
+        REQUIRE(MyInt::AliveCount() == 0);
+        REQUIRE(pool.NumAvailable() == 2);
+    }
+
+    SECTION("Thread local pool") {
+        auto& pool = StoragePool<Message>::Local();
+        size_t available = pool.NumAvailable();
+        {
+            auto msg = MakeLocalPooledUnique<Message>(3, "local");
+            REQUIRE(msg->body == "local");
+            REQUIRE(pool.NumInUse() == 1);
+        }
+        REQUIRE(pool.NumInUse() == 0);
+        REQUIRE(pool.NumAvailable() == std::max<size_t>(available, 1));
+    }
+
+    SECTION("Throwing constructor") {
+        struct Throws {
+            Throws() {
+                throw std::runtime_error("no");
+            }
+        };
+        StoragePool<Throws> pool;
+        REQUIRE_THROWS(MakePooledUnique<Throws>(pool));
+        REQUIRE(pool.NumInUse() == 0);
+        REQUIRE(pool.NumAvailable() == 1);
+        REQUIRE(pool.Stats().misses == 0);
+        REQUIRE(pool.Stats().allocations == 1);
+
+        REQUIRE_THROWS(MakePooledUnique<Throws>(pool));
+        REQUIRE(pool.NumAvailable() == 1);
+        REQUIRE(pool.Stats().reuses == 0);
+    }
+
+    SECTION("Over-aligned") {
+        struct alignas(64) Wide {
+            char data[64];
+        };
+        StoragePool<Wide> pool;
+        auto p = MakePooledUnique<Wide>(pool);
+        REQUIRE(reinterpret_cast<uintptr_t>(p.Get()) % 64 == 0);
+    }
+}
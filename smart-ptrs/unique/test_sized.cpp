@@ -0,0 +1,108 @@
+#include "sized.h"
+
+#include <catch.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+template <typename Array>
+void CheckResize() {
+    Array arr(10);
+    REQUIRE(arr.Size() == 10);
+    for (auto x : arr) {
+        REQUIRE(x == 0);
+    }
+    std::iota(arr.begin(), arr.end(), 1);
+
+    arr.Resize(5);
+    REQUIRE(arr.Size() == 5);
+    REQUIRE(arr[4] == 5);
+
+    arr.Resize(100000);
+    REQUIRE(arr.Size() == 100000);
+    for (size_t i = 0; i < 5; ++i) {
+        REQUIRE(arr[i] == static_cast<int64_t>(i + 1));
+    }
+    for (size_t i = 5; i < arr.Size(); ++i) {
+        REQUIRE(arr[i] == 0);
+    }
+
+    arr.Resize(0);
+    REQUIRE(arr.Empty());
+    arr.Resize(3);
+    REQUIRE(arr[2] == 0);
+}
+
+TEST_CASE("Sized array") {
+    SECTION("Empty") {
+        SizedUniqueArray<int> arr;
+        REQUIRE(arr.Size() == 0);
+        REQUIRE(arr.Data() == nullptr);
+        REQUIRE(arr.Span().empty());
+    }
+
+    SECTION("Span") {
+        SizedUniqueArray<int> arr(4);
+        std::span<int> s = arr;
+        REQUIRE(s.size() == 4);
+        s[3] = 7;
+        REQUIRE(arr[3] == 7);
+
+        const auto& carr = arr;
+        std::span<const int> cs = carr;
+        REQUIRE(cs.data() == arr.Data());
+    }
+
+    SECTION("Move") {
+        SizedUniqueArray<int> a(3);
+        a[0] = 1;
+        SizedUniqueArray<int> b = std::move(a);
+        REQUIRE(b.Size() == 3);
+        REQUIRE(b[0] == 1);
+        REQUIRE(a.Empty());
+        REQUIRE(!a.Data());
+        REQUIRE(a.Span().empty());
+
+        a.Resize(4);
+        for (int x : a) {
+            REQUIRE(x == 0);
+        }
+
+        a = std::move(b);
+        REQUIRE(a.Size() == 3);
+        REQUIRE(a[0] == 1);
+        REQUIRE(b.Empty());
+        a.Reset();
+        REQUIRE(a.Empty());
+    }
+
+    SECTION("Heap resize") {
+        CheckResize<SizedUniqueArray<int64_t>>();
+    }
+
+    SECTION("Mmap resize") {
+        CheckResize<MmapSizedUniqueArray<int64_t>>();
+    }
+
+    SECTION("Overflowing size") {
+        constexpr size_t kHuge = std::numeric_limits<size_t>::max() / 4 + 1;
+        REQUIRE_THROWS_AS(SizedUniqueArray<int64_t>(kHuge), std::bad_alloc);
+
+        MmapSizedUniqueArray<int64_t> arr(10);
+        arr[9] = 1;
+        REQUIRE_THROWS_AS(arr.Resize(kHuge), std::bad_alloc);
+        REQUIRE(arr.Size() == 10);
+        REQUIRE(arr[9] == 1);
+    }
+
+    SECTION("Mmap shrink then grow clears the tail") {
+        MmapSizedUniqueArray<char> arr(100);
+        std::fill(arr.begin(), arr.end(), 'x');
+        arr.Resize(10);
+        arr.Resize(100);
+        REQUIRE(arr[9] == 'x');
+        REQUIRE(arr[10] == 0);
+        REQUIRE(arr[99] == 0);
+    }
+}
@@ -0,0 +1,64 @@
+#include "tagged_unique.h"
+
+#include <common/my_int.h>
+
+#include <catch.hpp>
+
+struct alignas(8) Leaf {
+    int value = 0;
+};
+
+// Tagged pointers as members of the type they point to
+struct TreeNode {
+    TaggedUniquePtr<TreeNode, 1> left, right;
+};
+
+TEST_CASE("Tagged UniquePtr") {
+    static_assert(sizeof(TaggedUniquePtr<Leaf, 3>) == sizeof(void*));
+    static_assert(sizeof(TaggedUniquePtr<MyInt, 2>) == sizeof(void*));
+
+    SECTION("Pointer and tag") {
+        TaggedUniquePtr<Leaf, 3> ptr(new Leaf{5}, 6);
+        REQUIRE(ptr->value == 5);
+        REQUIRE(ptr.GetTag() == 6);
+
+        ptr.SetTag(9);  // only 3 bits
+        REQUIRE(ptr.GetTag() == 1);
+        REQUIRE(ptr->value == 5);
+
+        ptr.Reset(new Leaf{7});
+        REQUIRE(ptr.GetTag() == 1);
+        REQUIRE(ptr->value == 7);
+    }
+
+    SECTION("Self-referential node") {
+        static_assert(sizeof(TreeNode) == 2 * sizeof(void*));
+        TreeNode root;
+        root.left = TaggedUniquePtr<TreeNode, 1>(new TreeNode, 1);
+        root.left->right = TaggedUniquePtr<TreeNode, 1>(new TreeNode);
+        REQUIRE(root.left.GetTag() == 1);
+        REQUIRE(root.left->right);
+        REQUIRE(!root.right);
+    }
+
+    SECTION("Move and release") {
+        {
+            TaggedUniquePtr<MyInt, 2> first(new MyInt(1), 3);
+            TaggedUniquePtr<MyInt, 2> second(std::move(first));
+            REQUIRE(!first);
+            REQUIRE(second.GetTag() == 3);
+            REQUIRE(MyInt::AliveCount() == 1);
+
+            TaggedUniquePtr<MyInt, 2> third(UniquePtr<MyInt>(new MyInt(2)), 1);
+            third = std::move(second);
+            REQUIRE(MyInt::AliveCount() == 1);
+            REQUIRE(third.GetTag() == 3);
+
+            MyInt* raw = third.Release();
+            REQUIRE(!third);
+            REQUIRE(third.GetTag() == 3);
+            delete raw;
+        }
+        REQUIRE(MyInt::AliveCount() == 0);
+    }
+}